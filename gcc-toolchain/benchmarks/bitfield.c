@@ -0,0 +1,39 @@
+/**
+ * Mask and address computation benchmark
+ *
+ * Updates GPIO-style bit masks (set/clear/invert with a mask) and walks
+ * word and double-word tables by index. With Zbb/Zba the masks use
+ * ANDN/ORN/XNOR and the indexed addresses use SH2ADD/SH3ADD.
+ */
+
+static const unsigned int masks[8] = {
+    0x01, 0x03, 0x0F, 0x30, 0x81, 0xF0, 0x5A, 0xA5
+};
+
+static const unsigned long long wide[8] = {
+    1, 3, 5, 7, 11, 13, 17, 19
+};
+
+int main() {
+    unsigned int port = 0xFF;
+    unsigned int sum = 0;
+
+    for (int i = 0; i < 8; i++) {
+        port = port & ~masks[i];                    // ANDN: clear pins
+        port = port | ~masks[(i + 3) & 7];          // ORN
+        port = ~(port ^ masks[(i + 5) & 7]);        // XNOR: conditional invert
+        port &= 0xFF;
+    }
+
+    for (int i = 0; i < 8; i++) {
+        int j = (i * 5) & 7;
+        sum += masks[j] + (unsigned int)wide[j];    // SH2ADD / SH3ADD indexing
+    }
+
+    int result = port + sum;
+
+    volatile int * gpio = (int *) 0x00000000; // GPIO base address
+    *gpio = result; // Store result in GPIO
+
+    return result; // Reported by the testbench through the TOHOST mailbox
+}
@@ -0,0 +1,39 @@
+/**
+ * Byte swap benchmark
+ *
+ * Converts a buffer of 32-bit words from little to big endian and packs
+ * 16-bit fields, the pattern used to build UART protocol frames.
+ * With Zbb the swap is a single REV8 and the field packing uses ZEXT.H/ROR.
+ */
+
+static const unsigned int payload[16] = {
+    0x01020304, 0x05060708, 0x090A0B0C, 0x0D0E0F10,
+    0x11121314, 0x15161718, 0x191A1B1C, 0x1D1E1F20,
+    0xDEADBEEF, 0xCAFEBABE, 0x12345678, 0x9ABCDEF0,
+    0x0BADF00D, 0xFEEDFACE, 0x00C0FFEE, 0x8BADF00D
+};
+
+static inline unsigned int ror16(unsigned int x) {
+    return (x >> 16) | (x << 16);
+}
+
+int main() {
+    unsigned int frame[16];
+    unsigned int check = 0;
+
+    for (int i = 0; i < 16; i++) {
+        frame[i] = __builtin_bswap32(payload[i]);
+    }
+
+    for (int i = 0; i < 16; i++) {
+        unsigned int lo = frame[i] & 0xFFFF;
+        check ^= ror16(lo | (frame[i] & 0xFFFF0000)) + lo;
+    }
+
+    int result = check;
+
+    volatile int * gpio = (int *) 0x00000000; // GPIO base address
+    *gpio = result; // Store result in GPIO
+
+    return result; // Reported by the testbench through the TOHOST mailbox
+}
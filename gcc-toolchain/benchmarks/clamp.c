@@ -0,0 +1,40 @@
+/**
+ * Saturation benchmark
+ *
+ * Clamps a stream of signed sensor samples to a window and tracks the
+ * running minimum/maximum. With Zbb the comparisons become MIN/MAX
+ * (and MINU/MAXU) instead of compare-and-branch sequences.
+ */
+
+static const short samples[24] = {
+    120, -340, 5021, -7000, 32, 0, -1, 2048,
+    -2049, 999, 31000, -31000, 7, 812, -812, 4000,
+    -4000, 15, 16, -17, 1234, -4321, 3000, -3000
+};
+
+static inline int clamp(int x, int lo, int hi) {
+    x = x < lo ? lo : x;
+    return x > hi ? hi : x;
+}
+
+int main() {
+    int acc = 0;
+    int vmin = 0x7FFFFFFF;
+    int vmax = -0x7FFFFFFF - 1;
+    unsigned int umax = 0;
+
+    for (int i = 0; i < 24; i++) {
+        int s = samples[i];                         // SEXT.H on the loaded halfword
+        acc += clamp(s, -2048, 2047);
+        vmin = s < vmin ? s : vmin;
+        vmax = s > vmax ? s : vmax;
+        umax = (unsigned int)s > umax ? (unsigned int)s : umax;
+    }
+
+    int result = acc + vmin + vmax + (int)umax;
+
+    volatile int * gpio = (int *) 0x00000000; // GPIO base address
+    *gpio = result; // Store result in GPIO
+
+    return result; // Reported by the testbench through the TOHOST mailbox
+}
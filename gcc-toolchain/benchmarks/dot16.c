@@ -0,0 +1,51 @@
+/**
+ * Packed 16-bit dot product benchmark
+ *
+ * Correlates a block of int16 samples with a reference sequence at a few
+ * lags, as in a preamble or tone detector. The samples are read as 32-bit
+ * words holding two int16 values; PMAC16 multiplies both halves and adds them
+ * to the accumulator in one instruction, where RV32IM needs two sign
+ * extensions, two MULs and two ADDs per word.
+ */
+
+#include <stdint.h>
+#include "mac.h"
+
+#define LEN     32      // int16 elements per correlation
+#define LAGS    4       // Even lags, so the packed reads stay word aligned
+
+typedef uint32_t __attribute__((may_alias)) pair_t;
+
+static const int16_t reference[LEN] __attribute__((aligned(4))) = {
+    1000, -1000, 1000, 1000, -1000, -1000, 1000, -1000,
+    3000, 2000, -2000, -3000, 32767, -32768, 7, -7,
+    -1000, 1000, -1000, -1000, 1000, 1000, -1000, 1000,
+    12, 34, 56, 78, -12, -34, -56, -78
+};
+
+static const int16_t signal[LEN + 2 * LAGS] __attribute__((aligned(4))) = {
+    5, -9, 1020, -998, 1003, 987, -1010, -995,
+    996, -1002, 2990, 2010, -1990, -3010, 32000, -32000,
+    6, -6, -1004, 1001, -997, -1003, 1000, 999,
+    -1001, 1002, 11, 35, 57, 77, -13, -33,
+    -55, -79, 400, -400, 0, 0, -32768, 32767
+};
+
+int main() {
+    int result = 0;
+
+    for (int lag = 0; lag < 2 * LAGS; lag += 2) {
+        const pair_t * x = (const pair_t *) &signal[lag];
+        const pair_t * r = (const pair_t *) reference;
+        int acc = 0;
+        for (int i = 0; i < LEN / 2; i++) {
+            acc = rvcpu_pmac16(acc, x[i], r[i]);
+        }
+        result ^= acc + lag;
+    }
+
+    volatile int * gpio = (int *) 0x00000000; // GPIO base address
+    *gpio = result; // Store result in GPIO
+
+    return result; // Reported by the testbench through the TOHOST mailbox
+}
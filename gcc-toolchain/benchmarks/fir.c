@@ -0,0 +1,38 @@
+/**
+ * FIR filter benchmark
+ *
+ * 8-tap integer FIR filter over a block of 32-bit samples, the inner loop of
+ * most sensor filtering code. With the custom MAC instruction each tap is a
+ * load pair and one MAC instead of a MUL and an ADD.
+ */
+
+#include "mac.h"
+
+#define TAPS    8
+#define SAMPLES 24
+
+static const int coeffs[TAPS] = { -3, 12, -41, 160, 160, -41, 12, -3 };
+
+static const int samples[SAMPLES + TAPS - 1] = {
+    120, -340, 5021, -7000, 32, 0, -1, 2048,
+    -2049, 999, 31000, -31000, 7, 812, -812, 4000,
+    -4000, 15, 16, -17, 1234, -4321, 3000, -3000,
+    100000, -100000, 65535, -65536, 1, 2, 3
+};
+
+int main() {
+    int result = 0;
+
+    for (int n = 0; n < SAMPLES; n++) {
+        int acc = 0;
+        for (int k = 0; k < TAPS; k++) {
+            acc = rvcpu_mac(acc, samples[n + k], coeffs[k]);
+        }
+        result ^= acc + n;
+    }
+
+    volatile int * gpio = (int *) 0x00000000; // GPIO base address
+    *gpio = result; // Store result in GPIO
+
+    return result; // Reported by the testbench through the TOHOST mailbox
+}
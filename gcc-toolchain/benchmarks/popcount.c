@@ -0,0 +1,31 @@
+/**
+ * Bit counting benchmark
+ *
+ * Counts the set bits and the leading zeros of a table of 32-bit words,
+ * as used for GPIO change detection and fixed-point normalisation.
+ * With Zbb each loop body reduces to a CPOP and a CLZ instruction.
+ */
+
+static const unsigned int samples[16] = {
+    0x00000000, 0x00000001, 0x80000000, 0xFFFFFFFF,
+    0x0F0F0F0F, 0x12345678, 0xDEADBEEF, 0x00010000,
+    0x7FFFFFFF, 0x00FF00FF, 0xCAFEBABE, 0x00000100,
+    0x55555555, 0xAAAAAAAA, 0x0000FFFF, 0x3C3C3C3C
+};
+
+int main() {
+    unsigned int bits = 0;
+    unsigned int norm = 0;
+
+    for (int i = 0; i < 16; i++) {
+        bits += __builtin_popcount(samples[i]);
+        if (samples[i]) norm += __builtin_clz(samples[i]);
+    }
+
+    int result = bits + norm;
+
+    volatile int * gpio = (int *) 0x00000000; // GPIO base address
+    *gpio = result; // Store result in GPIO
+
+    return result; // Reported by the testbench through the TOHOST mailbox
+}
@@ -0,0 +1,31 @@
+/**
+ * Host mailbox helpers for programs run in the Verilator testbenches
+ *
+ * The mailbox is decoded in CPU_TOP.sv (HOST_MAILBOX) at 0x000000C0:
+ * - TOHOST  (0xC0): writing it ends the simulation, the value is the exit code
+ * - PUTCHAR (0xC4): one character printed by the testbench
+ *
+ * start.S already writes the return value of main to TOHOST, so host_exit()
+ * is only needed to stop from somewhere else in the program.
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+#define HOST_TOHOST  ((volatile int *) 0x000000C0)
+#define HOST_PUTCHAR ((volatile int *) 0x000000C4)
+
+static inline void host_putchar(char c) {
+    *HOST_PUTCHAR = c;
+}
+
+static inline void host_puts(const char * s) {
+    while (*s) host_putchar(*s++);
+}
+
+static inline void host_exit(int code) {
+    *HOST_TOHOST = code;
+    while (1);
+}
+
+#endif // HOST_H
@@ -0,0 +1,41 @@
+/**
+ * Multiply-accumulate helpers for the custom-0 instructions of the ALU
+ *
+ *     mac     rd, rs1, rs2    rd += rs1 * rs2 (low 32 bits)
+ *     pmac16  rd, rs1, rs2    rd += rs1[15:0] * rs2[15:0] + rs1[31:16] * rs2[31:16]
+ *                             (signed 16-bit lanes)
+ *
+ * Both are R-type with opcode custom-0 (0x0B), funct7 = 0 and funct3 = 0 / 1.
+ * rd is read as the accumulator, so the compiler sees it as an in/out operand.
+ * Build with -DUSE_MAC to emit the instructions (the assembler encodes them
+ * with .insn, no compiler support is needed); without it the helpers are plain
+ * C, so the same source runs on any RV32IM core.
+ */
+
+#ifndef MAC_H
+#define MAC_H
+
+#include <stdint.h>
+
+static inline int32_t rvcpu_mac(int32_t acc, int32_t a, int32_t b) {
+#ifdef USE_MAC
+    __asm__ (".insn r CUSTOM_0, 0, 0, %0, %1, %2" : "+r" (acc) : "r" (a), "r" (b));
+    return acc;
+#else
+    return (int32_t) ((uint32_t) acc + (uint32_t) a * (uint32_t) b);
+#endif
+}
+
+// a and b each hold two int16_t, element 0 in the low half (little-endian array order)
+static inline int32_t rvcpu_pmac16(int32_t acc, uint32_t a, uint32_t b) {
+#ifdef USE_MAC
+    __asm__ (".insn r CUSTOM_0, 1, 0, %0, %1, %2" : "+r" (acc) : "r" (a), "r" (b));
+    return acc;
+#else
+    int32_t lo = (int16_t) a * (int16_t) b;
+    int32_t hi = (int16_t) (a >> 16) * (int16_t) (b >> 16);
+    return (int32_t) ((uint32_t) acc + (uint32_t) lo + (uint32_t) hi);
+#endif
+}
+
+#endif // MAC_H
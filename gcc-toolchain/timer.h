@@ -0,0 +1,78 @@
+/**
+ * Timer helpers: 64-bit mtime/mtimecmp (RISC-V CLINT style) and event capture
+ *
+ * Registers of src/Timer.sv at 0x00000080. mtime counts clock cycles from
+ * reset. Channel n is pending while mtime >= mtimecmp[n] (TIMER_CMP_STATUS);
+ * writing a later compare value clears it, e.g. for a periodic task:
+ *
+ *     uint64_t next = timer_mtime() + PERIOD;
+ *     timer_set_mtimecmp(0, next);
+ *     while (1) {
+ *         if (timer_pending(0)) { next += PERIOD; timer_set_mtimecmp(0, next); task(); }
+ *     }
+ *
+ * Capture: timer_capture_arm() selects the events (GPIO edges, UART start
+ * bit); the first one latches mtime, read back with timer_captured().
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+#define TIMER_BASE          0x00000080
+#define TIMER_REG(off)      (*(volatile uint32_t *) (TIMER_BASE + (off)))
+
+#define TIMER_MTIME         TIMER_REG(0x10)
+#define TIMER_MTIMEH        TIMER_REG(0x14)
+#define TIMER_MTIMECMP(n)   TIMER_REG(0x18 + 8 * (n))
+#define TIMER_MTIMECMPH(n)  TIMER_REG(0x1C + 8 * (n))
+#define TIMER_CMP_STATUS    TIMER_REG(0x30)
+#define TIMER_CAP_CTRL      TIMER_REG(0x34)
+#define TIMER_CAPTURE       TIMER_REG(0x38)
+#define TIMER_CAPTUREH      TIMER_REG(0x3C)
+
+#define TIMER_CAP_GPIO_RISE(mask)  ((uint32_t) (mask) & 0xFF)
+#define TIMER_CAP_GPIO_FALL(mask)  (((uint32_t) (mask) & 0xFF) << 8)
+#define TIMER_CAP_UART_RX          (1u << 16)
+#define TIMER_CAP_CAPTURED         (1u << 24)
+#define TIMER_CAP_OVERRUN          (1u << 25)
+
+// hi/lo/hi: retry if the low word wrapped between the two reads
+static inline uint64_t timer_read64(volatile uint32_t * lo, volatile uint32_t * hi) {
+    uint32_t h, l;
+    do {
+        h = *hi;
+        l = *lo;
+    } while (h != *hi);
+    return ((uint64_t) h << 32) | l;
+}
+
+static inline uint64_t timer_mtime(void) {
+    return timer_read64(&TIMER_MTIME, &TIMER_MTIMEH);
+}
+
+// The low word is set to all ones first so no smaller intermediate value can match
+static inline void timer_set_mtimecmp(int n, uint64_t value) {
+    TIMER_MTIMECMP(n)  = 0xFFFFFFFF;
+    TIMER_MTIMECMPH(n) = (uint32_t) (value >> 32);
+    TIMER_MTIMECMP(n)  = (uint32_t) value;
+}
+
+static inline int timer_pending(int n) {
+    return (TIMER_CMP_STATUS >> n) & 1;
+}
+
+// Select the capture events and clear a previous capture
+static inline void timer_capture_arm(uint32_t sources) {
+    TIMER_CAP_CTRL = sources | TIMER_CAP_CAPTURED | TIMER_CAP_OVERRUN;
+}
+
+// Returns 1 and the captured mtime once an event has been seen
+static inline int timer_captured(uint64_t * time) {
+    if (!(TIMER_CAP_CTRL & TIMER_CAP_CAPTURED)) return 0;
+    *time = ((uint64_t) TIMER_CAPTUREH << 32) | TIMER_CAPTURE;
+    return 1;
+}
+
+#endif // TIMER_H
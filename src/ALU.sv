@@ -30,14 +30,17 @@
 module ALU #(
    parameter SIZE=32,
    parameter FAST_MUL_EN=0, // Enable fast multiplier
-   parameter DIVIDER_EN=1  // Enable divider
+   parameter DIVIDER_EN=1, // Enable divider
+   parameter BITMANIP_EN=1, // Enable Zba/Zbb operations
+   parameter MAC_EN=1 // Enable the custom-0 multiply-accumulate operations
 ) (
    input wire clk,
    input wire rst_n,
 
    input  wire [SIZE-1:0] A,
    input  wire [SIZE-1:0] B,
-   input  wire [4:0] opcode,
+   input  wire [SIZE-1:0] C, // Accumulator (rd) for MAC and PMAC16
+   input  wire [5:0] opcode,
    output reg [SIZE-1:0] out,
    output reg zero,
    output reg negative,
@@ -52,45 +55,116 @@ module ALU #(
 
    Muldiv #(
       .FAST_MUL_EN(FAST_MUL_EN),  // Enable fast multiplier
-      .DIVIDER_EN(DIVIDER_EN)    // Enable divider
+      .DIVIDER_EN(DIVIDER_EN),   // Enable divider
+      .MAC_EN(MAC_EN)            // Enable multiply-accumulate
    )muldiv(
       .clk(clk),
       .rst_n(rst_n&~done_muldiv), // Reset only when not done
       .a(A),
       .b(B),
+      .c(C),
       .opcode(opcode),
       .result(mul_div_res),
       .done(done_muldiv)
    );
 
 
-   typedef enum logic [4:0] {
-      ADD   = 5'b000_0_0,
-      SUB   = 5'b000_1_0,
-      AND   = 5'b111_0_0,
-      OR    = 5'b110_0_0,
-      XOR   = 5'b100_0_0,
-      SLL   = 5'b001_0_0,
-      SRL   = 5'b101_0_0,
-      SRA   = 5'b101_1_0,
-      SLT   = 5'b010_0_0,
-      SLTU  = 5'b011_0_0,
+   typedef enum logic [5:0] {
+      ADD   = 6'b0_000_0_0,
+      SUB   = 6'b0_000_1_0,
+      AND   = 6'b0_111_0_0,
+      OR    = 6'b0_110_0_0,
+      XOR   = 6'b0_100_0_0,
+      SLL   = 6'b0_001_0_0,
+      SRL   = 6'b0_101_0_0,
+      SRA   = 6'b0_101_1_0,
+      SLT   = 6'b0_010_0_0,
+      SLTU  = 6'b0_011_0_0,
 
       // Multiply and Divide operations
-      MUL   = 5'b000_0_1,
-      MULH  = 5'b001_0_1,
-      MULSU = 5'b010_0_1,
-      MULU  = 5'b011_0_1,
-      DIV   = 5'b100_0_1,
-      DIVU  = 5'b101_0_1,
-      REM   = 5'b110_0_1,
-      REMU  = 5'b111_0_1
+      MUL   = 6'b0_000_0_1,
+      MULH  = 6'b0_001_0_1,
+      MULSU = 6'b0_010_0_1,
+      MULU  = 6'b0_011_0_1,
+      DIV   = 6'b0_100_0_1,
+      DIVU  = 6'b0_101_0_1,
+      REM   = 6'b0_110_0_1,
+      REMU  = 6'b0_111_0_1,
+
+      // Zba/Zbb bit manipulation operations (decoded in ALU_dec.sv)
+      ANDN  = 6'b1_00000,
+      ORN   = 6'b1_00001,
+      XNOR  = 6'b1_00010,
+      CLZ   = 6'b1_00011,
+      CTZ   = 6'b1_00100,
+      CPOP  = 6'b1_00101,
+      MIN   = 6'b1_00110,
+      MINU  = 6'b1_00111,
+      MAX   = 6'b1_01000,
+      MAXU  = 6'b1_01001,
+      SEXTB = 6'b1_01010,
+      SEXTH = 6'b1_01011,
+      ZEXTH = 6'b1_01100,
+      REV8  = 6'b1_01101,
+      ROL   = 6'b1_01110,
+      ROR   = 6'b1_01111,
+      SH1ADD= 6'b1_10000,
+      SH2ADD= 6'b1_10001,
+      SH3ADD= 6'b1_10010,
+
+      // Multiply-accumulate (custom-0), executed by Muldiv
+      MAC   = 6'b1_10011,
+      PMAC16= 6'b1_10100
    } opcode_t;
 
+   // Count leading/trailing zeros. Returns 32 for a zero operand.
+   function automatic [SIZE-1:0] count_lz(input [SIZE-1:0] val);
+      count_lz = SIZE;
+      for (int i = 0; i < SIZE; i++) begin
+         if (val[i]) count_lz = SIZE-1-i;
+      end
+   endfunction
+
+   function automatic [SIZE-1:0] count_tz(input [SIZE-1:0] val);
+      count_tz = SIZE;
+      for (int i = SIZE-1; i >= 0; i--) begin
+         if (val[i]) count_tz = i;
+      end
+   endfunction
+
+   reg [SIZE-1:0] bitmanip_res;
+   wire [5:0] rot_amount = 6'd32 - {1'b0, B[4:0]};
+
+   always_comb begin
+      case (opcode)
+         ANDN:    bitmanip_res = A & ~B;
+         ORN:     bitmanip_res = A | ~B;
+         XNOR:    bitmanip_res = ~(A ^ B);
+         CLZ:     bitmanip_res = count_lz(A);
+         CTZ:     bitmanip_res = count_tz(A);
+         CPOP:    bitmanip_res = $countones(A);
+         MIN:     bitmanip_res = (signed_A < signed_B) ? A : B;
+         MINU:    bitmanip_res = (A < B) ? A : B;
+         MAX:     bitmanip_res = (signed_A < signed_B) ? B : A;
+         MAXU:    bitmanip_res = (A < B) ? B : A;
+         SEXTB:   bitmanip_res = {{24{A[7]}}, A[7:0]};
+         SEXTH:   bitmanip_res = {{16{A[15]}}, A[15:0]};
+         ZEXTH:   bitmanip_res = {16'b0, A[15:0]};
+         REV8:    bitmanip_res = {A[7:0], A[15:8], A[23:16], A[31:24]};
+         ROL:     bitmanip_res = (A << B[4:0]) | (A >> rot_amount);   // Shift by 32 yields 0 when B[4:0] == 0
+         ROR:     bitmanip_res = (A >> B[4:0]) | (A << rot_amount);
+         SH1ADD:  bitmanip_res = (A << 1) + B;
+         SH2ADD:  bitmanip_res = (A << 2) + B;
+         SH3ADD:  bitmanip_res = (A << 3) + B;
+         default: bitmanip_res = 32'b0;
+      endcase
+   end
+
    always_comb begin
 
       done = (opcode == MUL || opcode == MULH || opcode == MULSU || opcode == MULU || 
-               opcode == DIV || opcode == DIVU || opcode == REM || opcode == REMU) ? done_muldiv : 1'b1;
+               opcode == DIV || opcode == DIVU || opcode == REM || opcode == REMU ||
+               (MAC_EN && (opcode == MAC || opcode == PMAC16))) ? done_muldiv : 1'b1;
 
       case (opcode)         
          ADD:  out = A + B;
@@ -109,6 +183,17 @@ module ALU #(
             out = mul_div_res; // Take the lower 32 bits of the result
          end
 
+         MAC, PMAC16:
+         begin
+            out = MAC_EN ? mul_div_res : 32'b0; // Disabled: not written back (CPU_control)
+         end
+
+         ANDN, ORN, XNOR, CLZ, CTZ, CPOP, MIN, MINU, MAX, MAXU,
+         SEXTB, SEXTH, ZEXTH, REV8, ROL, ROR, SH1ADD, SH2ADD, SH3ADD:
+         begin
+            out = BITMANIP_EN ? bitmanip_res : 32'b0; // Disabled: not written back (CPU_control)
+         end
+
          default: out = 32'b0;
       endcase
 
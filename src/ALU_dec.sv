@@ -28,41 +28,136 @@
  */
 
 
+/*
+ *  ALU control decoder.
+ *
+ *  ALUcontrol[5] = 0 selects the RV32IM operations, encoded as {funct3, funct7[5], funct7[0]}.
+ *  ALUcontrol[5] = 1 selects the Zba/Zbb operations listed in ALU.sv. These live in the
+ *  unused funct7 encodings of OP and OP-IMM, so the instruction decoder needs no change.
+ *  The multiply-accumulate instructions use the custom-0 opcode (mac from Instr_dec):
+ *  funct3 = 000 is MAC (rd += rs1 * rs2), funct3 = 001 is PMAC16 (rd += rs1.h0 * rs2.h0 +
+ *  rs1.h1 * rs2.h1, signed halves). The other funct3 values are reserved: they decode as ADD
+ *  and CPU_control drops the register write, so they are no-ops.
+ */
+
 module ALU_dec (
-    input wire        funct7b1,
-    input wire        funct7b6,
+    input wire  [6:0] funct7,
+    input wire  [4:0] rs2,          // rs2 field (or imm[4:0] for OP-IMM)
     input wire  [2:0] funct3,
     input wire  [1:0] ALUop,
-    output reg [4:0] ALUcontrol
+    input wire        mac,          // Custom-0 opcode
+    output reg [5:0] ALUcontrol
 );
 
+    wire funct7b1 = funct7[0];  // M extension
+    wire funct7b6 = funct7[5];  // SUB and SRA
     wire [4:0] funct3_7b6b1 = {funct3, funct7b6, funct7b1}; // Concatenate funct3 and funct7 bits 6 and 5
 
+    // Zba/Zbb ALU control values (see ALU.sv)
+    localparam [5:0] ANDN   = 6'b1_00000;
+    localparam [5:0] ORN    = 6'b1_00001;
+    localparam [5:0] XNOR   = 6'b1_00010;
+    localparam [5:0] CLZ    = 6'b1_00011;
+    localparam [5:0] CTZ    = 6'b1_00100;
+    localparam [5:0] CPOP   = 6'b1_00101;
+    localparam [5:0] MIN    = 6'b1_00110;
+    localparam [5:0] MINU   = 6'b1_00111;
+    localparam [5:0] MAX    = 6'b1_01000;
+    localparam [5:0] MAXU   = 6'b1_01001;
+    localparam [5:0] SEXTB  = 6'b1_01010;
+    localparam [5:0] SEXTH  = 6'b1_01011;
+    localparam [5:0] ZEXTH  = 6'b1_01100;
+    localparam [5:0] REV8   = 6'b1_01101;
+    localparam [5:0] ROL    = 6'b1_01110;
+    localparam [5:0] ROR    = 6'b1_01111;
+    localparam [5:0] SH1ADD = 6'b1_10000;
+    localparam [5:0] SH2ADD = 6'b1_10001;
+    localparam [5:0] SH3ADD = 6'b1_10010;
+
+    // Multiply-accumulate (custom-0)
+    localparam [5:0] MAC    = 6'b1_10011;
+    localparam [5:0] PMAC16 = 6'b1_10100;
+
     always_comb begin
         case (ALUop)
             2'b01: begin    // Branch
                 case(funct3)  // Bits 2:1 of funct3 define the alu control value. Bit zero is unnecessary
-                    3'b000: ALUcontrol = 5'b00010; // BEQ - SUB
-                    3'b001: ALUcontrol = 5'b00010; // BNE - SUB
-                    3'b100: ALUcontrol = 5'b00010; // BLT - SUB
-                    3'b101: ALUcontrol = 5'b00010; // BGE - SUB
-                    3'b110: ALUcontrol = 5'b01100; // BLTU - SLTU
-                    3'b111: ALUcontrol = 5'b01100; // BGEU - SLTU
-                    default: ALUcontrol = 5'b00010; // Default to SUB
+                    3'b000: ALUcontrol = 6'b000010; // BEQ - SUB
+                    3'b001: ALUcontrol = 6'b000010; // BNE - SUB
+                    3'b100: ALUcontrol = 6'b001000; // BLT - SLT (the SUB sign is wrong on overflow)
+                    3'b101: ALUcontrol = 6'b001000; // BGE - SLT
+                    3'b110: ALUcontrol = 6'b001100; // BLTU - SLTU
+                    3'b111: ALUcontrol = 6'b001100; // BGEU - SLTU
+                    default: ALUcontrol = 6'b000010; // Default to SUB
                 endcase
             end
             2'b00: begin    // Load/Store
-                ALUcontrol = 5'b00000; // ADD
+                ALUcontrol = 6'b000000; // ADD
             end
             2'b11: begin    // I-type
                 if (funct3 == 3'b101) begin
-                    ALUcontrol = funct3_7b6b1; // SRAI
+                    case (funct7)
+                        7'b0110000: ALUcontrol = ROR;                                   // RORI
+                        7'b0110100: ALUcontrol = (rs2 == 5'b11000) ? REV8 : {1'b0, funct3_7b6b1};
+                        default:    ALUcontrol = {1'b0, funct3_7b6b1};                  // SRLI, SRAI
+                    endcase
+                end else if (funct3 == 3'b001 && funct7 == 7'b0110000) begin
+                    case (rs2)
+                        5'b00000: ALUcontrol = CLZ;
+                        5'b00001: ALUcontrol = CTZ;
+                        5'b00010: ALUcontrol = CPOP;
+                        5'b00100: ALUcontrol = SEXTB;
+                        5'b00101: ALUcontrol = SEXTH;
+                        default:  ALUcontrol = {1'b0, funct3, 2'b00};
+                    endcase
                 end else begin
-                    ALUcontrol = {funct3,2'b00};  // Maybe in hardware I can keep all equal to {funct3,1'b0,1'b0} and change only the SUB case. Need to check easiest implementation
+                    ALUcontrol = {1'b0, funct3, 2'b00};  // Maybe in hardware I can keep all equal to {funct3,1'b0,1'b0} and change only the SUB case. Need to check easiest implementation
                 end
             end
             default: begin  // R-type (2'b10)
-                ALUcontrol = funct3_7b6b1;
+                ALUcontrol = {1'b0, funct3_7b6b1};
+
+                if (mac) begin
+                    case (funct3)
+                        3'b000:  ALUcontrol = MAC;
+                        3'b001:  ALUcontrol = PMAC16;
+                        default: ALUcontrol = 6'b000000;    // Reserved: ADD, not written back
+                    endcase
+                end else case (funct7)
+                    7'b0100000: begin   // Zbb logic with negate
+                        case (funct3)
+                            3'b111: ALUcontrol = ANDN;
+                            3'b110: ALUcontrol = ORN;
+                            3'b100: ALUcontrol = XNOR;
+                            default: ;  // SUB, SRA
+                        endcase
+                    end
+                    7'b0000101: begin   // Zbb min/max
+                        case (funct3)
+                            3'b100: ALUcontrol = MIN;
+                            3'b101: ALUcontrol = MINU;
+                            3'b110: ALUcontrol = MAX;
+                            3'b111: ALUcontrol = MAXU;
+                            default: ;
+                        endcase
+                    end
+                    7'b0010000: begin   // Zba shift-and-add
+                        case (funct3)
+                            3'b010: ALUcontrol = SH1ADD;
+                            3'b100: ALUcontrol = SH2ADD;
+                            3'b110: ALUcontrol = SH3ADD;
+                            default: ;
+                        endcase
+                    end
+                    7'b0000100: begin   // Zbb zext.h (RV32 encoding)
+                        if (funct3 == 3'b100 && rs2 == 5'b00000) ALUcontrol = ZEXTH;
+                    end
+                    7'b0110000: begin   // Zbb rotates
+                        if (funct3 == 3'b001) ALUcontrol = ROL;
+                        if (funct3 == 3'b101) ALUcontrol = ROR;
+                    end
+                    default: ;
+                endcase
 
 
                 // case (funct3_7b6b1)
@@ -82,4 +177,4 @@ module ALU_dec (
         endcase
     end
 
-endmodule
\ No newline at end of file
+endmodule
@@ -38,9 +38,31 @@
 // Uncomment this line to program the instruction memory with a binary file
 `define PROGRAM_MEMORY 
 
+// Host mailbox at HOST_BASE_ADDR (TOHOST exit code and PUTCHAR console) read by the
+// simulation testbenches. Left out when SYNTHESIS is defined (genus_synth.tcl defines it).
+`ifndef SYNTHESIS
+`define HOST_MAILBOX 
+`endif
+
 // Uncomment this line to expose the Wishbone bus for external peripherals
 // `define EXPOSE_WB_BUS 
 
+// Uncomment this line to add a registered response slice after every peripheral (GPIO, UART,
+// Timer, host mailbox, external bus) in the interconnect. Reads from them take one more cycle,
+// RAM and IMEM reads are unchanged.
+// `define REGISTERED_RESPONSES 
+
+// Uncomment this line to back the data memory with the sparse DPI-C model (simulation only).
+// The RAM covers the full RAM_SIZE window and, when the bus is not exposed, the EXT window too.
+// Requires tests/common/sparse_mem.cpp to be linked into the testbench.
+// `define USE_DPI_RAM 
+
+// Uncomment one of these lines to gate the peripheral clocks (Clock_gate.sv). USE_ICG_CELL maps
+// the gates to the library ICG cell and cannot be simulated using verilator; USE_CLOCK_GATING
+// uses a behavioural latch gate. Without them the clock enables act as synchronous enables.
+// `define USE_ICG_CELL 
+// `define USE_CLOCK_GATING 
+
 
 
 
@@ -75,13 +97,20 @@ module SYSTEM_TOP (
 
     // UART interface
     output wire uart_tx,
-    input wire uart_rx
+    input wire uart_rx,
+
+    // Boot strap: load the instruction memory over uart_rx after reset (see Programming_controller)
+    input wire uart_boot
 
 );
 
     localparam PC_SIZE = 32; // Program Counter size
     localparam MEM_ADDR_WIDTH = 10; // Instruction Memory size in log2
+`ifdef USE_DPI_RAM
+    localparam DATA_MEM_ADDR_WIDTH = 20; // Whole RAM_SIZE window (1 MB from address 0)
+`else
     localparam DATA_MEM_ADDR_WIDTH = 16; // 2^8=(256) Number of words Data Memory size in log2
+`endif
 
     // Define base addresses and sizes for peripherals
     localparam logic [31:0] GPIO_BASE_ADDR  = 32'h00000000;
@@ -93,7 +122,9 @@ module SYSTEM_TOP (
     localparam logic [31:0] TIMER_BASE_ADDR = 32'h00000080;
     localparam logic [31:0] TIMER_SIZE      = 32'h00000040; // 64 bytes
 
-    localparam logic [31:0] RAM_BASE_ADDR   = 32'h00000100;
+    localparam logic [31:0] HOST_BASE_ADDR  = 32'h000000C0;
+    localparam logic [31:0] HOST_SIZE       = 32'h00000040; // 64 bytes
+
     localparam logic [31:0] RAM_SIZE        = 32'h00100000; // 1 MB
 
     localparam logic [31:0] IMEM_BASE_ADDR  = 32'h80000000;
@@ -102,6 +133,11 @@ module SYSTEM_TOP (
     localparam logic [31:0] EXT_BASE_ADDR   = 32'h10000000;
     localparam logic [31:0] EXT_SIZE        = 32'h00100000; // 1 MB
 
+`ifdef USE_DPI_RAM
+    // Sparse memory: storage lives in C++, so the whole window can be addressed
+    localparam EXT_MEM_ADDR_WIDTH = 20;
+`endif
+
     wire system_rst_n; // System reset signal
     wire jtag_rst_n; // CPU reset signal for programming
     assign system_rst_n = rst_n && jtag_rst_n; // System reset is active low, can be overridden by JTAG reset
@@ -126,6 +162,12 @@ module SYSTEM_TOP (
     wire [31:0]   i_data_uart;
     wire [31:0]   i_data_imem;
     wire [31:0]   i_data_timer;
+    wire          i_ack_host;
+    wire [31:0]   i_data_host;
+`ifndef EXPOSE_WB_BUS
+    wire          i_ack_ext_ram;
+    wire [31:0]   i_data_ext_ram;
+`endif
 
     wire [PC_SIZE-1:0]   PC; // Instruction Memory Data Output
     wire [31:0]   instruction; // Instruction output from Instruction Memory
@@ -165,49 +207,96 @@ module SYSTEM_TOP (
 
 
     //////////////////////////////////////////////////////////////////////
-    // Wishbone Interface Multiplexer
+    // Wishbone Interconnect
     //////////////////////////////////////////////////////////////////////
 
-    wire ram_select;
-    wire gpio_select;
-    wire imem_select;
-    wire uart_select;
-    wire timer_select;
-    assign imem_select = o_wb_address[31];
-    // verilator lint_off UNSIGNED
-    assign gpio_select = (o_wb_address >= GPIO_BASE_ADDR) && (o_wb_address < (GPIO_BASE_ADDR + GPIO_SIZE));
-    // verilator lint_on UNSIGNED
-    assign uart_select = (o_wb_address >= UART_BASE_ADDR) && (o_wb_address < (UART_BASE_ADDR + UART_SIZE));
-    assign timer_select = (o_wb_address >= TIMER_BASE_ADDR) && (o_wb_address < (TIMER_BASE_ADDR + TIMER_SIZE));
-    assign ram_select  = (o_wb_address >= RAM_BASE_ADDR) && (o_wb_address < (RAM_BASE_ADDR + RAM_SIZE));
+    // Memory map: base, mask (size - 1) and response latency of each slave (see Interconnect.sv).
+    // The RAM window starts at 0: GPIO, UART, Timer and the host mailbox sit in its first
+    // 256 bytes and take precedence, so the RAM is selected from 0x100 (DMEM in linker.ld).
+    // IMEM is decoded on bit 31 only.
+    localparam int S_RAM   = 0;
+    localparam int S_IMEM  = 1;
+    localparam int S_GPIO  = 2;
+    localparam int S_UART  = 3;
+    localparam int S_TIMER = 4;
+    localparam int S_HOST  = 5;
+    localparam int S_EXT   = 6;
+    localparam int N_SLAVES = 7;
+
+`ifdef REGISTERED_RESPONSES
+    localparam int PERIPH_LATENCY = 1;
+`else
+    localparam int PERIPH_LATENCY = 0;
+`endif
+
+    localparam logic [31:0] SLAVE_BASE [N_SLAVES] = '{
+        32'h00000000,   IMEM_BASE_ADDR, GPIO_BASE_ADDR, UART_BASE_ADDR,
+        TIMER_BASE_ADDR, HOST_BASE_ADDR, EXT_BASE_ADDR
+    };
+    localparam logic [31:0] SLAVE_MASK [N_SLAVES] = '{
+        RAM_SIZE - 1,   32'h7FFFFFFF,   GPIO_SIZE - 1,  UART_SIZE - 1,
+        TIMER_SIZE - 1, HOST_SIZE - 1,  EXT_SIZE - 1
+    };
+    localparam int SLAVE_LATENCY [N_SLAVES] = '{
+        0,              0,              PERIPH_LATENCY, PERIPH_LATENCY,
+        PERIPH_LATENCY, PERIPH_LATENCY, PERIPH_LATENCY
+    };
+
+    wire [N_SLAVES-1:0] slave_stb;
+    wire [N_SLAVES-1:0] slave_ack;
+    wire [31:0]         slave_data [N_SLAVES];
+
+    Interconnect #(
+        .N_SLAVES(N_SLAVES),
+        .SLAVE_BASE(SLAVE_BASE),
+        .SLAVE_MASK(SLAVE_MASK),
+        .SLAVE_LATENCY(SLAVE_LATENCY)
+    ) interconnect (
+        .clk(clk),
+        .rst_n(system_rst_n),
+
+        .m_stb(o_wb_stb),
+        .m_cyc(o_wb_cyc),
+        .m_we(o_wb_we),
+        .m_adr(o_wb_address),
+        .m_ack(i_wb_ack),
+        .m_dat(i_wb_data),
+
+        .s_stb(slave_stb),
+        .s_ack(slave_ack),
+        .s_dat(slave_data)
+    );
+
+    assign slave_ack[S_RAM]    = i_ack_ram;
+    assign slave_ack[S_IMEM]   = i_ack_imem;
+    assign slave_ack[S_GPIO]   = i_ack_gpio;
+    assign slave_ack[S_UART]   = i_ack_uart;
+    assign slave_ack[S_TIMER]  = i_ack_timer;
+    assign slave_ack[S_HOST]   = i_ack_host;
+
+    assign slave_data[S_RAM]   = i_data_ram;
+    assign slave_data[S_IMEM]  = i_data_imem;
+    assign slave_data[S_GPIO]  = i_data_gpio;
+    assign slave_data[S_UART]  = i_data_uart;
+    assign slave_data[S_TIMER] = i_data_timer;
+    assign slave_data[S_HOST]  = i_data_host;
 
 
     `ifdef EXPOSE_WB_BUS
 
-        assign wb_stb = (o_wb_address >= EXT_BASE_ADDR) && (o_wb_address < (EXT_BASE_ADDR + EXT_SIZE)) && o_wb_stb;
+        assign wb_stb = slave_stb[S_EXT];
         assign wb_cyc = o_wb_cyc;
         assign wb_addr = o_wb_address;
         assign wb_wdata = o_wb_data;
         assign wb_we = o_wb_we;
         assign wb_sel = o_wb_sel;
 
-        assign i_wb_ack =  i_ack_ram || i_ack_gpio || i_ack_imem || i_ack_uart || i_ack_timer || wb_ack_ext;
-
-        assign i_wb_data =  i_ack_ram ? i_data_ram : 
-                            i_ack_imem ? i_data_imem :
-                            i_ack_gpio ? i_data_gpio : 
-                            i_ack_uart ? i_data_uart : 
-                            i_ack_timer ? i_data_timer : 
-                            wb_ack_ext ? wb_rdata : 32'h00000000;
+        assign slave_ack[S_EXT]  = wb_ack_ext;
+        assign slave_data[S_EXT] = wb_rdata;
     `else
 
-        assign i_wb_ack =  i_ack_ram || i_ack_gpio || i_ack_imem || i_ack_uart || i_ack_timer;
-
-        assign i_wb_data =  i_ack_ram ? i_data_ram : 
-                            i_ack_imem ? i_data_imem :
-                            i_ack_gpio ? i_data_gpio : 
-                            i_ack_uart ? i_data_uart : 
-                            i_ack_timer ? i_data_timer : 32'h00000000;
+        assign slave_ack[S_EXT]  = i_ack_ext_ram;
+        assign slave_data[S_EXT] = i_data_ext_ram;
 
     `endif
 
@@ -237,7 +326,7 @@ module SYSTEM_TOP (
         .instruction(imem_out),
 
         // Wishbone interface
-        .wb_stb_i(o_wb_stb && imem_select),  // Only assert the strobe signal when the address is not in the range of the memory
+        .wb_stb_i(slave_stb[S_IMEM]),
         .wb_cyc_i(o_wb_cyc),
         .wb_we_i(o_wb_we),
         .wb_adr_i({1'b0,o_wb_address[30:0]}),
@@ -258,7 +347,7 @@ module SYSTEM_TOP (
         .rst_n(system_rst_n),
 
         .we(o_wb_we),
-        .stb(o_wb_stb && ram_select),  // Only assert the strobe signal when the address is in the range of the memory
+        .stb(slave_stb[S_RAM]),
         .cyc(o_wb_cyc),
         .address(o_wb_address),
         .data_in(o_wb_data),
@@ -267,16 +356,45 @@ module SYSTEM_TOP (
         .sel(o_wb_sel)
     );
 
+    // When the Wishbone bus is not exposed the EXT window is backed by the sparse
+    // DPI memory as well, so large-memory firmware can run without a wrapper.
+`ifndef EXPOSE_WB_BUS
+`ifdef USE_DPI_RAM
+    RAM #(
+        .ADDR_WIDTH(EXT_MEM_ADDR_WIDTH)
+    ) ext_ram (
+        .clk(clk),
+        .rst_n(system_rst_n),
+
+        .we(o_wb_we),
+        .stb(slave_stb[S_EXT]),
+        .cyc(o_wb_cyc),
+        .address(o_wb_address),
+        .data_in(o_wb_data),
+        .data_out(i_data_ext_ram),
+        .ack(i_ack_ext_ram),
+        .sel(o_wb_sel)
+    );
+`else
+    assign i_ack_ext_ram = 1'b0;
+    assign i_data_ext_ram = 32'h00000000;
+`endif
+`endif
+
     //////////////////////////////////////////////////////////////////////
     // GPIO Peripheral
     //////////////////////////////////////////////////////////////////////
 
+    wire [7:0] gpio_rise;       // Timer capture events
+    wire [7:0] gpio_fall;
+    wire       uart_rx_start;
+
     GPIOs gpio (
         .clk(clk),
         .rst_n(system_rst_n),
 
         // Wishbone interface
-        .wb_stb_i(o_wb_stb && gpio_select),  // Only assert the strobe signal when the address is not in the range of the memory
+        .wb_stb_i(slave_stb[S_GPIO]),
         .wb_cyc_i(o_wb_cyc),
         .wb_we_i(o_wb_we),
         .wb_adr_i(o_wb_address),
@@ -288,7 +406,10 @@ module SYSTEM_TOP (
         .gpio_out(gpio_out),      // GPIO output
         .gpio_pullen(gpio_pullen), // Pull-up enable for GPIOs
         .gpio_dir(gpio_dir),      // Direction control for GPIOs
-        .gpio_in(gpio_in)         // External GPIO inputs
+        .gpio_in(gpio_in),        // External GPIO inputs
+
+        .gpio_rise(gpio_rise),    // Input edges for the Timer capture
+        .gpio_fall(gpio_fall)
     );
 
 
@@ -302,7 +423,7 @@ module SYSTEM_TOP (
         .rst_n(system_rst_n),
 
         // Wishbone interface
-        .wb_stb_i(o_wb_stb && uart_select),  // Only assert the strobe signal when the address is not in the range of the memory
+        .wb_stb_i(slave_stb[S_UART]),
         .wb_cyc_i(o_wb_cyc),
         .wb_we_i(o_wb_we),
         .wb_adr_i(o_wb_address),
@@ -313,8 +434,9 @@ module SYSTEM_TOP (
 
         // UART signals
         .txd(uart_tx), // UART transmit signal
-        .rxd(uart_rx)  // UART receive signal
+        .rxd(uart_rx),  // UART receive signal
 
+        .rx_start_o(uart_rx_start)
     );
 
 
@@ -327,17 +449,84 @@ module SYSTEM_TOP (
         .rst_n(system_rst_n),
 
         // Wishbone interface
-        .wb_stb_i(o_wb_stb && timer_select),  // Only assert the strobe signal when the address is not in the range of the memory
+        .wb_stb_i(slave_stb[S_TIMER]),
         .wb_cyc_i(o_wb_cyc),
         .wb_we_i(o_wb_we),
         .wb_sel_i(o_wb_sel),
         .wb_adr_i(o_wb_address),
         .wb_dat_i(o_wb_data),
         .wb_dat_o(i_data_timer),  // Connect to the Timer data output
-        .wb_ack_o(i_ack_timer)   // Connect to the Timer acknowledge signal
+        .wb_ack_o(i_ack_timer),  // Connect to the Timer acknowledge signal
+
+        // Capture events
+        .gpio_rise(gpio_rise),
+        .gpio_fall(gpio_fall),
+        .uart_rx_start(uart_rx_start)
     );
 
 
+    //////////////////////////////////////////////////////////////////////
+    // Host mailbox (simulation)
+    //////////////////////////////////////////////////////////////////////
+    // - 0x00: TOHOST  write: the program finished, the value is the exit code
+    //                 (start.S writes the return value of main). Reads return it.
+    // - 0x04: PUTCHAR write: one character for the testbench console
+    // The testbench polls tohost_valid and putchar_valid through the public signals.
+
+`ifdef HOST_MAILBOX
+    reg        tohost_valid;
+    reg [31:0] tohost_code;
+    reg        putchar_valid;
+    reg [7:0]  putchar_data;
+    reg        host_ack;
+
+    always_ff @(posedge clk) begin
+        if (!system_rst_n) begin
+            tohost_valid  <= 1'b0;
+            tohost_code   <= 32'b0;
+            putchar_valid <= 1'b0;
+            putchar_data  <= 8'b0;
+            host_ack      <= 1'b0;
+        end else begin
+            putchar_valid <= 1'b0;
+            host_ack      <= 1'b0;
+
+            if (slave_stb[S_HOST] && o_wb_cyc) begin
+                if (o_wb_we) begin
+                    case (o_wb_address[5:2])
+                        4'h0: begin
+                            tohost_valid <= 1'b1;
+                            tohost_code  <= o_wb_data;
+                        end
+                        4'h1: begin
+                            putchar_valid <= 1'b1;
+                            putchar_data  <= o_wb_data[7:0];
+                        end
+                        default: ;
+                    endcase
+                end else begin
+                    host_ack <= 1'b1;
+                end
+            end
+        end
+    end
+
+    assign i_ack_host  = host_ack;
+    assign i_data_host = tohost_code;
+`else
+    // No mailbox: reads of the region still complete (with 0) so a load cannot hang the CPU
+    reg host_ack;
+
+    always_ff @(posedge clk) begin
+        if (!system_rst_n) host_ack <= 1'b0;
+        else               host_ack <= slave_stb[S_HOST] && o_wb_cyc && !o_wb_we;
+    end
+
+    assign i_ack_host  = host_ack;
+    assign i_data_host = 32'h00000000;
+`endif
+
+
     //////////////////////////////////////////////////////////////////////
     // JTAG Interface
     //////////////////////////////////////////////////////////////////////
@@ -392,6 +581,9 @@ module SYSTEM_TOP (
         .jtag_rdata(jtag_rdata),
         .jtag_ack(jtag_ack),
 
+        .uart_boot(uart_boot),
+        .uart_rxd(uart_rx),
+
         .mem_addr(mem_waddr),
         .mem_wdata(mem_wdata),
         .mem_rdata(imem_out),
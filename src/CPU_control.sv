@@ -27,13 +27,16 @@
  * SOFTWARE.
  */
 
-module CPU_control (
-    input wire          funct7b1,
-    input wire          funct7b6,
+module CPU_control #(
+    parameter BITMANIP_EN = 1,  // Zba/Zbb enabled in the ALU
+    parameter MAC_EN = 1        // Custom-0 MAC/PMAC16 enabled in the ALU
+) (
+    input wire  [6:0]   funct7,
+    input wire  [4:0]   rs2,            // rs2 field, selects the Zbb unary operations
     input wire  [2:0]   funct3,
     input  wire [6:0]   opcode,
 
-    output wire [4:0]   ALUcontrol,
+    output wire [5:0]   ALUcontrol,
     output wire [2:0]   Imm_src,
     output wire         ALU_src,
     output wire         branch,
@@ -47,6 +50,8 @@ module CPU_control (
 );
 
     wire [1:0]   ALU_op;
+    wire         mac;
+    wire         dec_reg_write;
 
     Instr_dec instruction_decoder (
         .opcode(opcode),
@@ -56,22 +61,33 @@ module CPU_control (
         .mem_read(mem_read),
         .mem_write(mem_write),
         .mem_to_reg(mem_to_reg),
-        .reg_write(reg_write),
+        .reg_write(dec_reg_write),
         .imm_src(Imm_src),
         .jump(jump),
         .jump_reg(jump_reg),
-        .pc_sel(pc_sel)
+        .pc_sel(pc_sel),
+        .mac(mac)
     );
 
 
     ALU_dec alu_dec (
         .funct3(funct3),
-        .funct7b1(funct7b1),
-        .funct7b6(funct7b6),
+        .funct7(funct7),
+        .rs2(rs2),
         .ALUop(ALU_op),
+        .mac(mac),
         .ALUcontrol(ALUcontrol)
     );
 
+    // Zba/Zbb ALUcontrol values (see ALU_dec.sv): ANDN to SH3ADD, all below MAC
+    localparam [5:0] MAC = 6'b1_10011;
+    wire bitmanip_op = ALUcontrol[5] && ALUcontrol < MAC;
+
+    // No-ops: reserved custom-0 funct3 values (other than MAC 000 and PMAC16 001),
+    // and the instructions of a disabled extension
+    assign reg_write = dec_reg_write && !(mac && (funct3[2:1] != 2'b00 || !MAC_EN)) &&
+                       !(bitmanip_op && !BITMANIP_EN);
+
     
 
 endmodule
\ No newline at end of file
@@ -0,0 +1,77 @@
+/*
+ * Project:    RVCPU: SystemVerilog SoC implementing a RV32IM CPU
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2025 Luca Ridolfi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+ 
+
+/*
+    Clock gate
+
+    Clock enable insertion point for the peripherals. The gated clock only
+    pulses while en is high (en is sampled while clk is low, so gclk has no
+    glitches).
+
+    - USE_ICG_CELL:      integrated clock gate from the standard cell library
+                         (cannot be simulated using verilator)
+    - USE_CLOCK_GATING:  behavioural latch + AND gate
+    - neither:           gclk = clk. The peripherals also use en as a synchronous
+                         enable, so the behaviour is the same in all three cases.
+*/
+
+`default_nettype none
+`timescale 1ns/1ps
+
+module Clock_gate (
+    input  wire clk,
+    input  wire en,
+    output wire gclk
+);
+
+`ifdef USE_ICG_CELL
+
+    // tcbn65lpbwp7t latch-based clock gate (TE: scan test enable)
+    CKLNQD1BWP7T icg (
+        .CP(clk),
+        .E(en),
+        .TE(1'b0),
+        .Q(gclk)
+    );
+
+`elsif USE_CLOCK_GATING
+
+    reg en_latch;
+
+    always_latch begin
+        if (!clk) en_latch <= en;
+    end
+
+    assign gclk = clk & en_latch;
+
+`else
+
+    assign gclk = clk;
+
+`endif
+
+endmodule
@@ -28,6 +28,25 @@
  */
 
  
+/*
+    GPIO Module
+
+    Address mapping (64-byte window):
+    - 0x00: OUT    (Output register)
+    - 0x04: DIR    (Direction register)
+    - 0x08: PULLEN (Pull-up enable register)
+    - 0x0C: IN     (Input register - readonly)
+    - 0x10: SET    (Write 1 to set OUT bits - writeonly)
+    - 0x14: CLR    (Write 1 to clear OUT bits - writeonly)
+    - 0x18: TGL    (Write 1 to toggle OUT bits - writeonly)
+    - 0x1C: RISE   (Rising edge capture - write 1 to clear)
+    - 0x20: FALL   (Falling edge capture - write 1 to clear)
+
+    SET/CLR/TGL change single pins with one store, without a read-modify-write
+    of OUT. RISE/FALL latch the edges of the synchronized inputs, so short
+    pulses are not missed by a polling loop.
+*/
+
 `timescale 1ns/1ps
 `default_nettype none
 
@@ -51,7 +70,11 @@ module GPIOs #(
     input wire  [7:0] gpio_in,      // External GPIO inputs
     output wire [7:0] gpio_out,     // External GPIO outputs
     output wire [7:0] gpio_pullen,  // Pull-up enable for GPIOs
-    output wire [7:0] gpio_dir      // Direction control for GPIOs
+    output wire [7:0] gpio_dir,     // Direction control for GPIOs
+
+    // Edges of the synchronized inputs (one-cycle pulses, Timer capture)
+    output wire [7:0] gpio_rise,
+    output wire [7:0] gpio_fall
 );
 
     localparam OUT      = 2'b00;
@@ -59,6 +82,17 @@ module GPIOs #(
     localparam PULLEN   = 2'b10;
     localparam IN       = 2'b11;
 
+    // Word offsets in the 64-byte GPIO window (wb_adr_i[5:2])
+    localparam ADDR_OUT     = 4'h0; // 0x00 Output register
+    localparam ADDR_DIR     = 4'h1; // 0x04 Direction register
+    localparam ADDR_PULLEN  = 4'h2; // 0x08 Pull-up enable register
+    localparam ADDR_IN      = 4'h3; // 0x0C Input register (read-only)
+    localparam ADDR_SET     = 4'h4; // 0x10 OUT |= data  (write-only, reads 0)
+    localparam ADDR_CLR     = 4'h5; // 0x14 OUT &= ~data (write-only, reads 0)
+    localparam ADDR_TGL     = 4'h6; // 0x18 OUT ^= data  (write-only, reads 0)
+    localparam ADDR_RISE    = 4'h7; // 0x1C Rising edges seen on IN  (write 1 to clear)
+    localparam ADDR_FALL    = 4'h8; // 0x20 Falling edges seen on IN (write 1 to clear)
+
     wire [31:0] wb_data_in;
 
     // ------   GPIO registers ------
@@ -72,9 +106,21 @@ module GPIOs #(
 
     reg [GPIO_NUM-1:0] tmp_reg[1:0];
 
+    // Edge capture: a bit is set when the synchronized input changes and stays
+    // set until software writes 1 to it. A new edge wins over a clear in the same cycle.
+    reg  [GPIO_NUM-1:0] edge_rise;
+    reg  [GPIO_NUM-1:0] edge_fall;
+    wire [GPIO_NUM-1:0] in_rise = tmp_reg[1] & ~gpio_reg[IN][GPIO_NUM-1:0];
+    wire [GPIO_NUM-1:0] in_fall = ~tmp_reg[1] & gpio_reg[IN][GPIO_NUM-1:0];
+
+    wire wb_write = wb_stb_i & wb_cyc_i & wb_we_i & wb_sel_i[0]; // GPIO bits are in the lowest byte
+
     // Write data only on the valid GPIOs 
     assign wb_data_in = {{(32-GPIO_NUM){1'b0}}, wb_dat_i[7:0]};
 
+    assign gpio_rise = in_rise;
+    assign gpio_fall = in_fall;
+
     assign gpio_out = gpio_reg[OUT][7:0];
     assign gpio_dir = gpio_reg[DIR][7:0];
     assign gpio_pullen = gpio_reg[PULLEN][7:0];
@@ -85,6 +131,8 @@ module GPIOs #(
             gpio_reg[1] <= 32'b0;
             gpio_reg[2] <= 32'b0;
             gpio_reg[3] <= 32'b0; 
+            edge_rise <= {GPIO_NUM{1'b0}};
+            edge_fall <= {GPIO_NUM{1'b0}};
             wb_ack_o <= 1'b0;
         end else begin
             wb_ack_o <= 1'b0;
@@ -92,10 +140,14 @@ module GPIOs #(
             // Update GPIO input register
             gpio_reg[IN][7:0] <= tmp_reg[1];
 
+            // Edge capture with write-1-to-clear
+            edge_rise <= (edge_rise & ~((wb_write && wb_adr_i[5:2] == ADDR_RISE) ? wb_dat_i[GPIO_NUM-1:0] : {GPIO_NUM{1'b0}})) | in_rise;
+            edge_fall <= (edge_fall & ~((wb_write && wb_adr_i[5:2] == ADDR_FALL) ? wb_dat_i[GPIO_NUM-1:0] : {GPIO_NUM{1'b0}})) | in_fall;
+
             if (wb_stb_i & wb_cyc_i) begin
                 if(wb_we_i) begin
                     // Write only to OUT, DIR, and PULLEN registers
-                    if(wb_adr_i[3:2] != 2'b11) begin
+                    if(wb_adr_i[5:4] == 2'b00 && wb_adr_i[3:2] != 2'b11) begin
                         case(wb_sel_i)
                             4'b0001: gpio_reg[wb_adr_i[3:2]][ 7: 0] <= wb_data_in[7:0]; // Write to lower byte
                             4'b0010: gpio_reg[wb_adr_i[3:2]][15: 8] <= wb_data_in[7:0]; // Write to second byte
@@ -107,9 +159,25 @@ module GPIOs #(
                             default: gpio_reg[wb_adr_i[3:2]] <= wb_data_in; // Write full word if no specific byte selected
                         endcase
                     end
+
+                    // Atomic set/clear/toggle aliases of OUT
+                    if (wb_sel_i[0]) begin
+                        case (wb_adr_i[5:2])
+                            ADDR_SET: gpio_reg[OUT][7:0] <= gpio_reg[OUT][7:0] |  wb_data_in[7:0];
+                            ADDR_CLR: gpio_reg[OUT][7:0] <= gpio_reg[OUT][7:0] & ~wb_data_in[7:0];
+                            ADDR_TGL: gpio_reg[OUT][7:0] <= gpio_reg[OUT][7:0] ^  wb_data_in[7:0];
+                            default: ;
+                        endcase
+                    end
                 end else begin
                     // Read operation
-                    wb_dat_o <= gpio_reg[wb_adr_i[3:2]];  // Read from GPIO register 1
+                    case (wb_adr_i[5:2])
+                        ADDR_OUT, ADDR_DIR, ADDR_PULLEN, ADDR_IN:
+                                    wb_dat_o <= gpio_reg[wb_adr_i[3:2]];
+                        ADDR_RISE:  wb_dat_o <= {{(32-GPIO_NUM){1'b0}}, edge_rise};
+                        ADDR_FALL:  wb_dat_o <= {{(32-GPIO_NUM){1'b0}}, edge_fall};
+                        default:    wb_dat_o <= 32'b0;
+                    endcase
                     wb_ack_o <= 1'b1; // Acknowledge the transaction
                 end
             end
@@ -44,7 +44,8 @@ module Instr_dec (
     output reg  [2:0]   imm_src,
     output reg          jump,
     output reg          jump_reg,
-    output reg          pc_sel
+    output reg          pc_sel,
+    output reg          mac             // Custom-0 multiply-accumulate (rd is also a source)
     );
     
     localparam [6:0] OP_R    = 7'b0110011;
@@ -57,10 +58,13 @@ module Instr_dec (
     localparam [6:0] LUI     = 7'b0110111;
     localparam [6:0] AUIPC   = 7'b0010111;
     localparam [6:0] SYSTEM  = 7'b1110011;
+    localparam [6:0] CUSTOM0 = 7'b0001011;   // mac, pmac16
 
 
     always_comb begin
-        
+
+        mac = 1'b0;
+
         case (opcode)
             OP_R: begin
                 alu_op = 2'b10;
@@ -179,6 +183,20 @@ module Instr_dec (
                 jump_reg = 1'b0;
                 pc_sel = 1'b1;
             end
+            CUSTOM0: begin  // R-type layout, executed by the multiplier
+                alu_op = 2'b10;
+                ALU_src = 1'b0;
+                branch = 1'b0;
+                mem_read = 1'b0;
+                mem_write = 1'b0;
+                mem_to_reg = 2'b00;
+                reg_write = 1'b1;
+                imm_src = 3'b000;
+                jump = 1'b0;
+                jump_reg = 1'b0;
+                pc_sel = 1'b0;
+                mac = 1'b1;
+            end
             SYSTEM: begin
                 alu_op = 2'b00;
                 ALU_src = 1'b0;
@@ -0,0 +1,184 @@
+/*
+ * Project:    RVCPU: SystemVerilog SoC implementing a RV32IM CPU
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2025 Luca Ridolfi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+ 
+
+/*
+    Wishbone interconnect
+
+    Connects the CPU load/store port to N_SLAVES slaves described by a memory
+    map table (one entry per slave):
+
+    - SLAVE_BASE:    base address, aligned to the region size
+    - SLAVE_MASK:    region size - 1 (the size is a power of two)
+    - SLAVE_LATENCY: registered response stages added after the slave (0: none)
+
+    Decode: a slave is hit when (address & ~MASK) == BASE, so each region costs
+    an equality on the upper address bits only, and all slaves are decoded in
+    parallel (one-hot). A region may contain smaller regions (e.g. the
+    peripheral block at the bottom of the RAM window): the smaller region wins
+    and the larger one is masked off, which keeps the select one-hot without a
+    priority chain.
+
+    Response: acks are ORed and the data is an AND-OR mux of the slaves
+    qualified by their ack. A latency > 0 puts ack/data registers between the
+    slave and the mux, so slow or far-away slaves (external bus) do not add to
+    the load path of the CPU; each stage costs one cycle on reads from that
+    slave only. Writes are not acknowledged and never wait.
+
+    The CPU holds a read until it is acknowledged. The strobe to the slaves is
+    only issued on the first cycle of a read (pending blocks it until the ack
+    comes back), so a slave answers each read once whatever its latency.
+*/
+
+`default_nettype none
+
+module Interconnect #(
+    parameter int          N_SLAVES = 1,
+    parameter logic [31:0] SLAVE_BASE    [N_SLAVES] = '{default: 32'h00000000},
+    parameter logic [31:0] SLAVE_MASK    [N_SLAVES] = '{default: 32'hFFFFFFFF},
+    parameter int          SLAVE_LATENCY [N_SLAVES] = '{default: 0}
+) (
+    input  wire                 clk,
+    input  wire                 rst_n,
+
+    // Master (CPU) side
+    input  wire                 m_stb,
+    input  wire                 m_cyc,
+    input  wire                 m_we,
+    input  wire [31:0]          m_adr,
+    output wire                 m_ack,
+    output reg  [31:0]          m_dat,
+
+    // Slave side
+    output wire [N_SLAVES-1:0]  s_stb,
+    input  wire [N_SLAVES-1:0]  s_ack,
+    input  wire [31:0]          s_dat [N_SLAVES]
+);
+
+    wire [N_SLAVES-1:0] hit;        // Address inside the region
+    wire [N_SLAVES-1:0] sel;        // One-hot slave select
+    wire [N_SLAVES-1:0] resp_ack;   // Ack after the response slices
+    wire [31:0]         resp_dat [N_SLAVES];
+
+    reg pending;                    // Read issued, waiting for the ack
+
+
+    //////////////////////////////////////////////////////////////////////
+    // Address decode
+    //////////////////////////////////////////////////////////////////////
+
+    genvar i, j;
+    generate
+        for (i = 0; i < N_SLAVES; i++) begin : g_decode
+
+            // Memory map checks
+            if ((SLAVE_MASK[i] & (SLAVE_MASK[i] + 32'd1)) != 32'd0)
+                $error("Interconnect: slave %0d size is not a power of two", i);
+            if ((SLAVE_BASE[i] & SLAVE_MASK[i]) != 32'd0)
+                $error("Interconnect: slave %0d base is not aligned to its size", i);
+
+            assign hit[i] = (m_adr & ~SLAVE_MASK[i]) == SLAVE_BASE[i];
+
+            // Smaller regions nested in this one take precedence
+            wire [N_SLAVES-1:0] nested;
+            for (j = 0; j < N_SLAVES; j++) begin : g_nested
+                if (j != i && SLAVE_MASK[j] != SLAVE_MASK[i] && (SLAVE_MASK[j] & ~SLAVE_MASK[i]) == 32'd0
+                           && (SLAVE_BASE[j] & ~SLAVE_MASK[i]) == SLAVE_BASE[i]) begin : g_inner
+                    assign nested[j] = hit[j];
+                end else begin : g_outer
+                    if (j != i && SLAVE_MASK[j] == SLAVE_MASK[i] && SLAVE_BASE[j] == SLAVE_BASE[i])
+                        $error("Interconnect: slaves %0d and %0d have the same region", i, j);
+                    assign nested[j] = 1'b0;
+                end
+            end
+
+            assign sel[i] = hit[i] & ~|nested;
+        end
+    endgenerate
+
+    assign s_stb = sel & {N_SLAVES{m_stb & ~pending}};
+
+    always_ff @(posedge clk) begin
+        if (!rst_n) begin
+            pending <= 1'b0;
+        end else if (m_ack) begin
+            pending <= 1'b0;
+        end else if (m_stb && m_cyc && !m_we && |sel) begin
+            pending <= 1'b1;
+        end
+    end
+
+
+    //////////////////////////////////////////////////////////////////////
+    // Response slices
+    //////////////////////////////////////////////////////////////////////
+
+    generate
+        for (i = 0; i < N_SLAVES; i++) begin : g_resp
+            localparam int LATENCY = SLAVE_LATENCY[i];
+
+            if (LATENCY == 0) begin : g_direct
+                assign resp_ack[i] = s_ack[i];
+                assign resp_dat[i] = s_dat[i];
+            end else begin : g_slice
+                reg [LATENCY-1:0] ack_q;
+                reg [31:0]        dat_q [LATENCY];
+
+                // The data registers only load with an ack
+                always_ff @(posedge clk) begin
+                    if (!rst_n) begin
+                        ack_q <= '0;
+                    end else begin
+                        ack_q[0] <= s_ack[i];
+                        if (s_ack[i]) dat_q[0] <= s_dat[i];
+                        for (int k = 1; k < LATENCY; k++) begin
+                            ack_q[k] <= ack_q[k-1];
+                            if (ack_q[k-1]) dat_q[k] <= dat_q[k-1];
+                        end
+                    end
+                end
+
+                assign resp_ack[i] = ack_q[LATENCY-1];
+                assign resp_dat[i] = dat_q[LATENCY-1];
+            end
+        end
+    endgenerate
+
+
+    //////////////////////////////////////////////////////////////////////
+    // AND-OR response mux
+    //////////////////////////////////////////////////////////////////////
+
+    assign m_ack = |resp_ack;
+
+    always_comb begin
+        m_dat = 32'h00000000;
+        for (int k = 0; k < N_SLAVES; k++) begin
+            m_dat = m_dat | (resp_dat[k] & {32{resp_ack[k]}});
+        end
+    end
+
+endmodule
@@ -37,29 +37,36 @@ This module is to be revised.
 
 module Muldiv #(
     parameter FAST_MUL_EN = 0, // Enable fast multiplier 1, Iterative multiplier 0
-    parameter DIVIDER_EN = 1 // Enable divider 1, No divider 0
+    parameter DIVIDER_EN = 1, // Enable divider 1, No divider 0
+    parameter OPERAND_ISOLATION = 1, // Hold the datapath inputs at 0 for non M-extension opcodes
+    parameter MAC_EN = 1 // Enable the custom-0 multiply-accumulate instructions (MAC, PMAC16)
 )
 (
     input wire clk,
     input wire rst_n,
-    input wire [4:0] opcode,
+    input wire [5:0] opcode,
     input wire [31:0] a,
     input wire [31:0] b,
+    input wire [31:0] c, // Accumulator (rd) of MAC and PMAC16
     output reg [31:0] result,
     output reg done
 );
 
 
 
-typedef enum logic [4:0] {
-    MUL   = 5'b000_0_1,
-    MULH  = 5'b001_0_1,
-    MULSU = 5'b010_0_1,
-    MULU  = 5'b011_0_1,
-    DIV   = 5'b100_0_1,
-    DIVU  = 5'b101_0_1,
-    REM   = 5'b110_0_1,
-    REMU  = 5'b111_0_1
+typedef enum logic [5:0] {
+    MUL   = 6'b0_000_0_1,
+    MULH  = 6'b0_001_0_1,
+    MULSU = 6'b0_010_0_1,
+    MULU  = 6'b0_011_0_1,
+    DIV   = 6'b0_100_0_1,
+    DIVU  = 6'b0_101_0_1,
+    REM   = 6'b0_110_0_1,
+    REMU  = 6'b0_111_0_1,
+
+    // Multiply-accumulate (custom-0, see ALU_dec.sv)
+    MAC   = 6'b1_10011,     // c + a * b (low 32 bits)
+    PMAC16= 6'b1_10100      // c + a.h0 * b.h0 + a.h1 * b.h1, signed 16-bit lanes
 } opcode_t;
 
 
@@ -73,26 +80,60 @@ typedef enum logic [1:0] {
 
 state_t state;
 reg [4:0] count;
-reg [4:0] curr_opcode;
+reg [5:0] curr_opcode;
 reg [31:0] a_reg, b_reg; // Registers to hold inputs
+reg [31:0] c_reg; // Accumulator
 reg [31:0] quotient, remainder; // For division and remainder
 reg [63:0] mul_result; // For multiplication
 reg [63:0] div_accumulator; // For division
 reg sign_res;
 reg sign_a, sign_b; // For signed multiplication/division
 reg is_mult_reg, is_div_reg; // For checking if operation is multiplication or division
+reg lane_neg_l, lane_neg_h; // PMAC16: sign of each lane product
 
-wire is_mult, is_div;
+wire is_mult, is_div, is_mac, is_pmac;
 
-assign is_mult = (opcode == MUL || opcode == MULH || opcode == MULSU || opcode == MULU);
+assign is_mac = MAC_EN && (opcode == MAC || opcode == PMAC16);
+assign is_pmac = MAC_EN && opcode == PMAC16;
+assign is_mult = (opcode == MUL || opcode == MULH || opcode == MULSU || opcode == MULU) || is_mac;
 assign is_div = (opcode == DIV || opcode == DIVU || opcode == REM || opcode == REMU) ;
 
-wire sign_a_w = (opcode == MUL || opcode == MULH || opcode == MULSU || opcode == DIV || opcode == REM) ? a[31] : 1'b0;
-wire sign_b_w = (opcode == MUL || opcode == MULH || opcode == DIV || opcode == REM) ? b[31] : 1'b0;
-wire [31:0] a_abs = sign_a_w ? -a : a;
-wire [31:0] b_abs = sign_b_w ? -b : b;
+// Operand isolation: a and b are the ALU operands and change with every instruction.
+// Forcing them to 0 outside M-extension opcodes keeps the negation and the
+// fast multiplier (a_abs * b_abs) from switching when their result is not used.
+wire        is_muldiv = is_mult | is_div;
+wire [31:0] a_iso = (OPERAND_ISOLATION && !is_muldiv) ? 32'b0 : a;
+wire [31:0] b_iso = (OPERAND_ISOLATION && !is_muldiv) ? 32'b0 : b;
+wire [31:0] c_iso = (OPERAND_ISOLATION && !is_mac) ? 32'b0 : c;
+
+wire sign_a_w = (opcode == MUL || opcode == MULH || opcode == MULSU || opcode == DIV || opcode == REM) ? a_iso[31] : 1'b0;
+wire sign_b_w = (opcode == MUL || opcode == MULH || opcode == DIV || opcode == REM) ? b_iso[31] : 1'b0;
+wire [31:0] a_abs = sign_a_w ? -a_iso : a_iso;
+wire [31:0] b_abs = sign_b_w ? -b_iso : b_iso;
 wire sign_res_w = sign_a_w ^ sign_b_w;
 
+// MAC keeps the low 32 bits of the product, which do not depend on the operand signs,
+// so it runs as an unsigned multiply. PMAC16 takes the magnitude of each 16-bit lane
+// and applies the lane signs when the two products are added.
+wire [15:0] al_abs = a_iso[15] ? -a_iso[15:0] : a_iso[15:0];
+wire [15:0] ah_abs = a_iso[31] ? -a_iso[31:16] : a_iso[31:16];
+wire [15:0] bl_abs = b_iso[15] ? -b_iso[15:0] : b_iso[15:0];
+wire [15:0] bh_abs = b_iso[31] ? -b_iso[31:16] : b_iso[31:16];
+wire lane_neg_l_w = a_iso[15] ^ b_iso[15];
+wire lane_neg_h_w = a_iso[31] ^ b_iso[31];
+
+wire [31:0] a_op = is_pmac ? {ah_abs, al_abs} : a_abs;
+wire [31:0] b_op = is_pmac ? {bh_abs, bl_abs} : b_abs;
+
+// Fast multiplier as four 16x16 partial products. The full product uses all four,
+// PMAC16 only the two lane products, so the cross products are held at 0.
+wire [31:0] pp_ll = a_op[15:0] * b_op[15:0];
+wire [31:0] pp_hh = a_op[31:16] * b_op[31:16];
+wire [31:0] pp_lh = is_pmac ? 32'b0 : a_op[15:0] * b_op[31:16];
+wire [31:0] pp_hl = is_pmac ? 32'b0 : a_op[31:16] * b_op[15:0];
+wire [63:0] fast_product = {pp_hh, pp_ll} + ({32'b0, pp_lh} << 16) + ({32'b0, pp_hl} << 16);
+wire [31:0] fast_dot = (lane_neg_l_w ? -pp_ll : pp_ll) + (lane_neg_h_w ? -pp_hh : pp_hh);
+
 
 always_ff @(posedge clk) begin
     if(!rst_n) begin
@@ -103,7 +144,10 @@ always_ff @(posedge clk) begin
         done <= 1'b0;
         a_reg <= 32'b0;
         b_reg <= 32'b0;
-        curr_opcode <= 5'b0;
+        c_reg <= 32'b0;
+        lane_neg_l <= 1'b0;
+        lane_neg_h <= 1'b0;
+        curr_opcode <= 6'b0;
         sign_a <= 1'b0;
         sign_b <= 1'b0;
         sign_res <= 1'b0;
@@ -118,14 +162,14 @@ always_ff @(posedge clk) begin
                 done <= 1'b0; // Reset done signal
 
                 // Handle division by zero as a special case (1 cycle)
-                if (is_div && DIVIDER_EN && b == 32'b0) begin
+                if (is_div && DIVIDER_EN && b_iso == 32'b0) begin
                     done <= 1'b1;
                     state <= IDLE;
 
                     if (opcode == DIV || opcode == DIVU) begin
                         result <= 32'hFFFFFFFF; // Division by zero returns 0xFFFFFFFF
                     end else if (opcode == REM || opcode == REMU) begin
-                        result <= a; // Remainder is the dividend
+                        result <= a_iso; // Remainder is the dividend
                     end else begin
                         result <= 32'b0; // Default case for unsupported opcodes
                     end
@@ -155,13 +199,16 @@ always_ff @(posedge clk) begin
                     sign_b <= sign_b_w;
                     sign_res <= sign_res_w;
 
-                    a_reg <= a_abs;
-                    b_reg <= b_abs;
+                    a_reg <= a_op;
+                    b_reg <= b_op;
+                    c_reg <= c_iso;
+                    lane_neg_l <= lane_neg_l_w;
+                    lane_neg_h <= lane_neg_h_w;
 
                     if (is_mult) begin
                         if (FAST_MUL_EN) begin
                             state <= DONE; // Go directly to DONE for fast multiply
-                            mul_result <= a_abs * b_abs; // Use registered absolute values for fast path
+                            mul_result <= is_pmac ? {32'b0, fast_dot} : fast_product;
                         end else begin
                             state <= BUSY_MUL; // Use iterative multiplier
                         end
@@ -176,10 +223,19 @@ always_ff @(posedge clk) begin
 
             BUSY_MUL: begin
 
-                if (b_reg[count]) mul_result <= mul_result + ({32'b0,a_reg} << count);    
+                if (curr_opcode == PMAC16) begin
+                    // Both lanes in parallel, 16 steps
+                    logic [31:0] term_l, term_h;
+                    term_l = b_reg[count[3:0]]      ? {16'b0, a_reg[15:0]}  << count[3:0] : 32'b0;
+                    term_h = b_reg[16 + count[3:0]] ? {16'b0, a_reg[31:16]} << count[3:0] : 32'b0;
+                    mul_result[31:0] <= mul_result[31:0] + (lane_neg_l ? -term_l : term_l)
+                                                         + (lane_neg_h ? -term_h : term_h);
+                end else if (b_reg[count]) begin
+                    mul_result <= mul_result + ({32'b0,a_reg} << count);
+                end
                 count <= count + 1;
 
-                if(count == 5'd31) begin
+                if(count == 5'd31 || (curr_opcode == PMAC16 && count == 5'd15)) begin
                     state <= DONE; // Transition to DONE state when count reaches 0
                 end
             end
@@ -220,6 +276,9 @@ always_ff @(posedge clk) begin
                     MULU: begin
                         result <= mul_result[63:32]; // Unsigned multiplication high part
                     end
+                    MAC, PMAC16: begin
+                        result <= c_reg + mul_result[31:0]; // PMAC16 lane signs are already applied
+                    end
                     MULH: begin
                         logic [63:0] signed_res = sign_res ? -mul_result : mul_result;
                         result <= signed_res[63:32];
@@ -27,6 +27,28 @@
  * SOFTWARE.
  */
 
+
+/*
+ *  Instruction memory programming: JTAG (see JTAG.sv) or UART boot.
+ *
+ *  UART boot: when the uart_boot strap is high at the end of reset, the controller isolates
+ *  the instruction memory and listens on the UART RX pin (uart_boot_loader below). The strap
+ *  is only sampled while rst_n is low. JTAG has priority: jtag_en takes the controller out
+ *  of UART boot and the JTAG image replaces the UART one. The image is sent as one frame,
+ *  multi-byte fields little-endian:
+ *
+ *      SYNC     1 byte   0x55, measures the bit period (autobaud)
+ *      ADDR     4 bytes  load address (byte offset in the instruction memory)
+ *      LENGTH   4 bytes  number of 32-bit words
+ *      DATA     4 * LENGTH bytes
+ *      CRC      4 bytes  CRC-32 (IEEE 802.3, as zlib crc32) of ADDR, LENGTH and DATA
+ *
+ *  Each word is written to the instruction memory as soon as its last byte arrives. On a
+ *  good CRC the CPU is reset and starts from the new image (S_DONE, as after JTAG). On a
+ *  bad CRC, a framing error or a gap longer than 2^TIMEOUT_WIDTH cycles inside the frame
+ *  the loader waits for a new SYNC byte.
+ */
+
 module Programming_controller #(
     parameter MEM_ADDR_WIDTH = 6,
     parameter MEM_DATA_WIDTH = 32
@@ -44,6 +66,10 @@ module Programming_controller #(
     input  wire [MEM_ADDR_WIDTH-1:0] jtag_addr,
     input  wire [MEM_DATA_WIDTH-1:0] jtag_wdata,
 
+    // UART boot
+    input  wire        uart_boot,       // Boot strap: load the instruction memory from the UART after reset
+    input  wire        uart_rxd,        // UART RX pin (shared with the UART peripheral)
+
     // Memory interface
     output reg  [MEM_ADDR_WIDTH-1:0] mem_addr,
     output reg  [MEM_DATA_WIDTH-1:0] mem_wdata,
@@ -51,7 +77,7 @@ module Programming_controller #(
     output reg         mem_we,
     output reg         mem_control_enable,
 
-    // CPU reset on done state
+    // CPU reset on done state (after JTAG or UART boot)
     output reg        jtag_rst_n,
 
     // JTAG side outputs
@@ -67,10 +93,12 @@ module Programming_controller #(
     localparam S_WAIT_READ  = 3'b100; 
     localparam S_ACK        = 3'b101; 
     localparam S_DONE       = 3'b110;
+    localparam S_UART_BOOT  = 3'b111;
 
 
     reg [2:0] state, next_state;
     reg [1:0] reset_counter;
+    reg       uart_boot_req;        // Strap latched in reset, cleared once an image is loaded
 
     ////////////////////////////////////////////////////////////////////////////
     // Synchronization of JTAG request pulse to CPU clock domain    
@@ -99,6 +127,40 @@ module Programming_controller #(
 
 
 
+    ////////////////////////////////////////////////////////////////////////////
+    // UART boot loader
+    ////////////////////////////////////////////////////////////////////////////
+
+    wire [MEM_ADDR_WIDTH-1:0] boot_addr;
+    wire [MEM_DATA_WIDTH-1:0] boot_data;
+    wire       boot_we;
+    wire       boot_image_ok;
+    wire       boot_crc_error;      // Last frame failed the CRC check (debug)
+
+    // The strap is a static pin: it is sampled while in reset and ignored afterwards
+    always_ff @(posedge clk) begin
+        if (!rst_n) begin
+            uart_boot_req <= uart_boot;
+        end else if ((state == S_UART_BOOT && boot_image_ok) || state == S_JTAG_CTRL) begin
+            uart_boot_req <= 1'b0;
+        end
+    end
+
+    uart_boot_loader #(
+        .MEM_ADDR_WIDTH(MEM_ADDR_WIDTH)
+    ) uart_boot_ld (
+        .clk(clk),
+        .rst_n(rst_n),
+        .en(state == S_UART_BOOT),
+        .rxd(uart_rxd),
+        .word_addr(boot_addr),
+        .word_data(boot_data),
+        .word_valid(boot_we),
+        .image_ok(boot_image_ok),
+        .crc_error(boot_crc_error)
+    );
+
+
     ////////////////////////////////////////////////////////////////////////////
     // State Machine for JTAG Control
     ////////////////////////////////////////////////////////////////////////////
@@ -113,7 +175,16 @@ module Programming_controller #(
 
     always_comb begin
         case(state)
-            S_NORMAL_OPS: next_state = (jtag_en_sync) ? S_JTAG_CTRL : S_NORMAL_OPS;
+            S_NORMAL_OPS: begin
+                if (jtag_en_sync)       next_state = S_JTAG_CTRL;
+                else if (uart_boot_req) next_state = S_UART_BOOT;
+                else                    next_state = S_NORMAL_OPS;
+            end
+            S_UART_BOOT: begin
+                if (jtag_en_sync)       next_state = S_JTAG_CTRL;   // JTAG takes over, the frame is dropped
+                else if (boot_image_ok) next_state = S_DONE;
+                else                    next_state = S_UART_BOOT;
+            end
             S_JTAG_CTRL: begin
                 if(!jtag_en_sync) begin
                     next_state = S_DONE; // Exit JTAG mode
@@ -194,6 +265,14 @@ module Programming_controller #(
                     jtag_ack <= 1'b1; // Acknowledge operation
                 end
 
+                S_UART_BOOT: begin
+                    if (boot_we) begin
+                        mem_addr <= boot_addr;
+                        mem_wdata <= boot_data;
+                        mem_we <= 1'b1;
+                    end
+                end
+
                 S_DONE: begin
                     reset_counter <= reset_counter + 1; // Increment reset counter
                     jtag_rst_n <= 1'b0; // Assert CPU reset during done state
@@ -274,4 +353,207 @@ module cdc_signal_sync #(
         end
     end
 
-endmodule
\ No newline at end of file
+endmodule
+
+
+
+/*
+ *  UART boot loader: autobaud receiver and frame parser (format in Programming_controller).
+ *
+ *  The bit period is measured on the SYNC byte: 0x55 has a falling edge every two bits
+ *  (start bit, bits 1, 3, 5, 7), so the time between the first and the fifth falling edge
+ *  is 8 bit periods. Bytes are then sampled in the middle of each bit with that period.
+ *  word_valid pulses for one cycle with each DATA word, image_ok after a matching CRC.
+ *  crc_error stays set from a bad CRC until the next SYNC byte.
+ */
+
+module uart_boot_loader #(
+    parameter MEM_ADDR_WIDTH = 10,
+    parameter BAUD_WIDTH = 16,          // Bit period up to 2^BAUD_WIDTH - 1 clock cycles
+    parameter TIMEOUT_WIDTH = 24        // Idle cycles inside a frame before waiting for a new SYNC
+)(
+    input  wire        clk,
+    input  wire        rst_n,
+    input  wire        en,              // Boot mode, the loader is held idle while low
+    input  wire        rxd,
+
+    output reg  [MEM_ADDR_WIDTH-1:0] word_addr,
+    output reg  [31:0] word_data,
+    output reg         word_valid,
+    output reg         image_ok,
+    output reg         crc_error
+);
+
+    localparam [2:0] B_SYNC_WAIT    = 3'd0;    // Wait for the start bit of the SYNC byte
+    localparam [2:0] B_SYNC_MEASURE = 3'd1;    // Count cycles until the fifth falling edge
+    localparam [2:0] B_IDLE         = 3'd2;    // Between bytes
+    localparam [2:0] B_START        = 3'd3;    // Half a bit into the start bit
+    localparam [2:0] B_DATA         = 3'd4;
+    localparam [2:0] B_STOP         = 3'd5;
+
+    localparam [1:0] F_ADDR = 2'd0;
+    localparam [1:0] F_LEN  = 2'd1;
+    localparam [1:0] F_DATA = 2'd2;
+    localparam [1:0] F_CRC  = 2'd3;
+
+    localparam [31:0] CRC_POLY = 32'hEDB88320;  // CRC-32, reflected
+
+    function automatic [31:0] crc32_byte(input [31:0] crc, input [7:0] data);
+        crc32_byte = crc ^ {24'b0, data};
+        for (int i = 0; i < 8; i++) begin
+            crc32_byte = crc32_byte[0] ? (crc32_byte >> 1) ^ CRC_POLY : crc32_byte >> 1;
+        end
+    endfunction
+
+    reg [2:0]   rxd_sync;               // [1] synchronized RXD, [2] its previous value
+    wire        rxd_s = rxd_sync[1];
+    wire        rxd_fall = rxd_sync[2] && !rxd_sync[1];
+
+    reg [2:0]   rx_state;
+    reg [BAUD_WIDTH+2:0] count;         // Cycle counter, 8 bit periods during the measure
+    reg [BAUD_WIDTH-1:0] bit_cycles;    // Measured bit period
+    reg [2:0]   edges;                  // Falling edges seen after the first one
+    reg [2:0]   bit_index;
+    reg [7:0]   rx_byte;
+    reg [TIMEOUT_WIDTH-1:0] idle_count;
+
+    reg [1:0]   field;
+    reg [1:0]   byte_index;
+    reg [31:0]  shift;                  // Little-endian field assembly
+    reg [31:0]  words_left;
+    reg [MEM_ADDR_WIDTH-1:0] load_addr;
+    reg [31:0]  crc;
+
+    wire [31:0] word_in = {rx_byte, shift[31:8]};   // Field value once the fourth byte is in
+
+    always_ff @(posedge clk) begin
+        if (!rst_n || !en) begin
+            rxd_sync    <= 3'b111;
+            rx_state    <= B_SYNC_WAIT;
+            count       <= '0;
+            bit_cycles  <= '0;
+            edges       <= 3'd0;
+            bit_index   <= 3'd0;
+            rx_byte     <= 8'b0;
+            idle_count  <= '0;
+            field       <= F_ADDR;
+            byte_index  <= 2'd0;
+            shift       <= 32'b0;
+            words_left  <= 32'b0;
+            load_addr   <= '0;
+            crc         <= 32'hFFFFFFFF;
+            word_addr   <= '0;
+            word_data   <= 32'b0;
+            word_valid  <= 1'b0;
+            image_ok    <= 1'b0;
+            crc_error   <= 1'b0;
+        end else begin
+            rxd_sync   <= {rxd_sync[1:0], rxd};
+            word_valid <= 1'b0;
+            image_ok   <= 1'b0;
+
+            case (rx_state)
+                B_SYNC_WAIT: begin
+                    if (rxd_fall) begin
+                        count    <= 1;
+                        edges    <= 3'd0;
+                        rx_state <= B_SYNC_MEASURE;
+                    end
+                end
+
+                B_SYNC_MEASURE: begin
+                    count <= count + 1;
+                    if (&count) begin
+                        rx_state <= B_SYNC_WAIT;            // Line too slow or stuck low
+                    end else if (rxd_fall) begin
+                        edges <= edges + 1;
+                        if (edges == 3'd3 && count[BAUD_WIDTH+2:3] == '0) begin
+                            rx_state <= B_SYNC_WAIT;            // Shorter than one cycle per bit
+                        end else if (edges == 3'd3) begin
+                            bit_cycles <= count[BAUD_WIDTH+2:3];
+                            field      <= F_ADDR;
+                            byte_index <= 2'd0;
+                            crc        <= 32'hFFFFFFFF;
+                            crc_error  <= 1'b0;
+                            idle_count <= '0;
+                            rx_state   <= B_IDLE;           // Bit 7 and the stop bit are still on the line
+                        end
+                    end
+                end
+
+                B_IDLE: begin
+                    idle_count <= idle_count + 1;
+                    if (rxd_fall) begin
+                        count    <= '0;
+                        rx_state <= B_START;
+                    end else if (&idle_count) begin
+                        rx_state <= B_SYNC_WAIT;            // Frame abandoned
+                    end
+                end
+
+                B_START: begin
+                    count <= count + 1;
+                    if (count == {3'b0, bit_cycles >> 1}) begin
+                        count     <= '0;
+                        bit_index <= 3'd0;
+                        rx_state  <= rxd_s ? B_IDLE : B_DATA;   // Glitch if the line is high again
+                    end
+                end
+
+                B_DATA: begin
+                    count <= count + 1;
+                    if (count == {3'b0, bit_cycles - 1'b1}) begin
+                        count     <= '0;
+                        rx_byte   <= {rxd_s, rx_byte[7:1]};
+                        bit_index <= bit_index + 1;
+                        if (bit_index == 3'd7) rx_state <= B_STOP;
+                    end
+                end
+
+                B_STOP: begin
+                    count <= count + 1;
+                    if (count == {3'b0, bit_cycles - 1'b1}) begin
+                        idle_count <= '0;
+                        rx_state   <= rxd_s ? B_IDLE : B_SYNC_WAIT; // No stop bit: framing error
+
+                        if (rxd_s) begin
+                            // One byte received
+                            shift      <= word_in;
+                            byte_index <= byte_index + 1;
+                            if (field != F_CRC) crc <= crc32_byte(crc, rx_byte);
+
+                            if (byte_index == 2'd3) begin
+                                case (field)
+                                    F_ADDR: begin
+                                        load_addr <= word_in[MEM_ADDR_WIDTH-1:0];
+                                        field     <= F_LEN;
+                                    end
+                                    F_LEN: begin
+                                        words_left <= word_in;
+                                        field      <= (word_in == 32'b0) ? F_CRC : F_DATA;
+                                    end
+                                    F_DATA: begin
+                                        word_addr  <= load_addr;
+                                        word_data  <= word_in;
+                                        word_valid <= 1'b1;
+                                        load_addr  <= load_addr + 4;
+                                        words_left <= words_left - 1;
+                                        if (words_left == 32'd1) field <= F_CRC;
+                                    end
+                                    F_CRC: begin
+                                        image_ok  <= (word_in == ~crc);
+                                        crc_error <= (word_in != ~crc);
+                                        rx_state  <= B_SYNC_WAIT;
+                                    end
+                                endcase
+                            end
+                        end
+                    end
+                end
+
+                default: rx_state <= B_SYNC_WAIT;
+            endcase
+        end
+    end
+
+endmodule
@@ -103,6 +103,37 @@ module RAM #(
     end
 
 
+`elsif USE_DPI_RAM
+
+    // Simulation-only memory backed by the sparse paged model in tests/common/sparse_mem.cpp.
+    // No storage is allocated in the Verilated model: pages are created in C++ on first write,
+    // so ADDR_WIDTH can cover the full RAM_SIZE/EXT_SIZE windows at no extra cost.
+    // The full bus address is forwarded so that several RAM instances share one address space.
+    // Context imports: the C++ side finds the memory bound to this model from the calling scope.
+    import "DPI-C" context function int  dpi_mem_read(input int addr);
+    import "DPI-C" context function void dpi_mem_write(input int addr, input int data, input byte byte_en);
+
+    reg [31:0] read_data;
+    reg [3:0] byte_en;
+    reg [31:0] shifted_data_in;
+
+    always @(posedge clk) begin
+        if(!rst_n) begin
+            read_data <= {DATA_WIDTH{1'b0}};
+            ack <= 1'b0;
+        end else begin
+            ack <= 1'b0;
+            if(stb && cyc) begin
+                if(we) begin
+                    dpi_mem_write({address[31:2], 2'b00}, shifted_data_in, {4'b0, byte_en});
+                end else begin
+                    read_data <= dpi_mem_read({address[31:2], 2'b00});
+                    ack <= 1'b1; // Acknowledge the read operation
+                end
+            end
+        end
+    end
+
 `else
 
 
@@ -148,6 +179,10 @@ module RAM #(
         end
     end
 
+`endif
+
+
+`ifndef USE_COMPILED_SRAM
 
     // Byte enable and shifted data input for write operations
 
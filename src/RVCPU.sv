@@ -51,7 +51,9 @@
 
 module RVCPU #(
     parameter PC_SIZE = 32,
-    parameter DATA_MEM_SIZE_LOG = 8 // in Words
+    parameter DATA_MEM_SIZE_LOG = 8, // in Words
+    parameter BITMANIP_EN = 1,       // Enable Zba/Zbb operations
+    parameter MAC_EN = 1             // Enable custom-0 MAC/PMAC16
 )
 (
     input wire clk,
@@ -83,6 +85,7 @@ module RVCPU #(
     wire [31:0] w_data;             // Write Data
     wire [31:0] reg_out1;           // Read Data 1
     wire [31:0] reg_out2;           // Read Data 2
+    wire [31:0] reg_out3;           // Read Data 3 (rd, MAC accumulator)
     wire [31:0] alu_result;         // ALU Result   
     wire [31:0] mux_to_alu;         // Mux to ALU
 
@@ -106,7 +109,7 @@ module RVCPU #(
 
 
     // Control Signals
-    wire [4:0] ALUcontrol;      // ALU Control
+    wire [5:0] ALUcontrol;      // ALU Control
     wire [2:0] Imm_src;         // Immediate Source
     wire ALU_src;               // ALU Source
     wire branch;                // Branch
@@ -144,9 +147,12 @@ module RVCPU #(
     //////       Control Unit
     /////////////////////////////////////////////
 
-    CPU_control control_unit (
-        .funct7b1(instruction[25]),        // Funct7 bit 1 for multiplication and division
-        .funct7b6(instruction[30]),        // Funct7 bit 6 for SUB and SRA
+    CPU_control #(
+        .BITMANIP_EN(BITMANIP_EN),  // Disabled extensions do not write rd
+        .MAC_EN(MAC_EN)
+    ) control_unit (
+        .funct7(instruction[31:25]),       // Funct7 field: SUB/SRA, M extension and bit manipulation
+        .rs2(instruction[24:20]),          // rs2 field: Zbb unary operations (CLZ, CTZ, CPOP, SEXT, REV8)
         .funct3(funct3),
         .opcode(instruction[6:0]),
         .ALUcontrol(ALUcontrol),
@@ -204,11 +210,13 @@ module RVCPU #(
         .rst_n(rst_n),
         .r_addr1(r_addr1),
         .r_addr2(r_addr2),
+        .r_addr3(w_addr),
         .w_en(reg_write && !stall), // Write Enable, only if not stalled
         .w_addr(w_addr),
         .w_data(w_data),
         .out1(reg_out1),
-        .out2(reg_out2)
+        .out2(reg_out2),
+        .out3(reg_out3)
     );
 
     // Multiplexer to select the input to the ALU
@@ -235,13 +243,16 @@ module RVCPU #(
     // ALU
     ALU #(
         .FAST_MUL_EN(1),  // Enable fast multiplier
-        .DIVIDER_EN(1)    // Enable divider
+        .DIVIDER_EN(1),   // Enable divider
+        .BITMANIP_EN(BITMANIP_EN),  // Enable Zba/Zbb operations
+        .MAC_EN(MAC_EN)             // Enable custom-0 MAC/PMAC16
     ) alu (
         .clk(clk),
         .rst_n(rst_n),
 
         .A(reg_out1),
         .B(mux_to_alu),
+        .C(reg_out3),
         .opcode(ALUcontrol),
         .out(alu_result),
         .zero(alu_zero),
@@ -295,8 +306,8 @@ module RVCPU #(
 
     assign do_branch =  funct3 == 3'b000 && alu_zero        || 
                         funct3 == 3'b001 && !alu_zero       || 
-                        funct3 == 3'b100 && alu_negative    || 
-                        funct3 == 3'b101 && !alu_negative   || 
+                        funct3 == 3'b100 && !alu_zero       ||  // SLT: out is 1 when rs1 < rs2 (signed)
+                        funct3 == 3'b101 && alu_zero        || 
                         funct3 == 3'b110 && !alu_zero       ||  // This uses SLTU. If rs1 < rs2, then out is 1 and zero is 0. So for zero negated the comparison is true.
                         funct3 == 3'b111 && alu_zero;
 
@@ -28,7 +28,46 @@
  */
  
 
-module Timer (
+/*
+    Timer Module
+
+    Address mapping (64-byte window, wb_adr_i[5:2]):
+    - 0x00: CONTROL    bit0: enable, bit1: flag (write 1 to clear),
+                       bit2: MTIME_HALT (stops mtime, reset 0)
+    - 0x04: COUNTER    32-bit counter, auto-reloads to 0 after a compare match
+    - 0x08: PRESCALER  counter prescaler
+    - 0x0C: COMPARE    counter compare value (sets flag)
+    - 0x10: MTIME      mtime[31:0]
+    - 0x14: MTIMEH     mtime[63:32]
+    - 0x18: MTIMECMP0  / 0x1C: MTIMECMP0H
+    - 0x20: MTIMECMP1  / 0x24: MTIMECMP1H
+    - 0x28: MTIMECMP2  / 0x2C: MTIMECMP2H
+    - 0x30: CMP_STATUS bit n: mtime >= mtimecmp[n] (read-only)
+    - 0x34: CAP_CTRL   bits 7:0: GPIO rising edge enables, bits 15:8: GPIO
+                       falling edge enables, bit 16: UART RX start enable,
+                       bit 24: CAPTURED, bit 25: OVERRUN (write 1 to clear)
+    - 0x38: CAPTURE    captured mtime[31:0] (read-only)
+    - 0x3C: CAPTUREH   captured mtime[63:32] (read-only)
+
+    The first four registers are the original 32-bit timer and keep their
+    behaviour. mtime/mtimecmp follow the RISC-V CLINT: mtime is a 64-bit
+    free-running counter incremented every clock cycle, and a channel is
+    pending while mtime >= mtimecmp. The condition is a level: it is cleared
+    by writing a later mtimecmp, so each channel can run its own periodic task
+    (mtimecmp += period) without touching the others. As on the CLINT, a
+    64-bit value is read with the hi/lo/hi sequence and mtimecmp is updated by
+    writing the low word to -1 first.
+
+    Capture: the first enabled event (a GPIO edge after the input
+    synchronizer, or the start bit of a UART frame) latches mtime in CAPTURE
+    and sets CAPTURED. Further events while CAPTURED is set only set OVERRUN.
+    An event in the same cycle as the clear of CAPTURED is captured.
+*/
+
+
+module Timer #(
+    parameter CMP_CHANNELS = 3     // mtimecmp channels, at most 3 in the register map
+) (
     input  wire        clk,
     input  wire        rst_n,
 
@@ -40,9 +79,19 @@ module Timer (
     input  wire [31:0] wb_adr_i,
     input  wire [31:0] wb_dat_i,
     output reg  [31:0] wb_dat_o,
-    output reg         wb_ack_o
+    output reg         wb_ack_o,
+
+    // Capture events (one-cycle pulses)
+    input  wire [7:0]  gpio_rise,
+    input  wire [7:0]  gpio_fall,
+    input  wire        uart_rx_start
 );
 
+    generate
+        if (CMP_CHANNELS < 1 || CMP_CHANNELS > 3)
+            $error("Timer: CMP_CHANNELS must be between 1 and 3");
+    endgenerate
+
     // Timer registers
     reg        enable;
     reg        flag;
@@ -51,11 +100,62 @@ module Timer (
     reg [31:0] prescale_cnt;
     reg [31:0] compare;
 
+    // CLINT-style time base
+    reg        mtime_halt;
+    reg [63:0] mtime;
+    reg [63:0] mtimecmp [CMP_CHANNELS];
+    wire [CMP_CHANNELS-1:0] cmp_match;
+
+    // Capture
+    reg [7:0]  cap_rise_en;
+    reg [7:0]  cap_fall_en;
+    reg        cap_uart_en;
+    reg        captured;
+    reg        overrun;
+    reg [63:0] capture;
+
+    // Clock enable: the 32-bit counter only runs while the timer is enabled and
+    // mtime while it is not halted. Register writes and reset still need the clock.
+    wire wb_write = wb_cyc_i & wb_stb_i & wb_we_i;
+    wire timer_clk;
+    wire mtime_clk;
+
+    Clock_gate timer_cg (
+        .clk(clk),
+        .en(enable | wb_write | ~rst_n),
+        .gclk(timer_clk)
+    );
+
+    Clock_gate mtime_cg (
+        .clk(clk),
+        .en(~mtime_halt | wb_write | ~rst_n),
+        .gclk(mtime_clk)
+    );
+
     // Address map (word offsets)
-    localparam REG_CONTROL   = 2'h0; // bit0: enable, bit1: flag (read-only, cleared on write 1)
-    localparam REG_COUNTER   = 2'h1; // current counter value (read-only, writable to rst_n)
-    localparam REG_PRESCALER = 2'h2; // prescaler value
-    localparam REG_COMPARE   = 2'h3; // compare value
+    localparam REG_CONTROL    = 4'h0; // bit0: enable, bit1: flag (read-only, cleared on write 1), bit2: mtime halt
+    localparam REG_COUNTER    = 4'h1; // current counter value (read-only, writable to rst_n)
+    localparam REG_PRESCALER  = 4'h2; // prescaler value
+    localparam REG_COMPARE    = 4'h3; // compare value
+    localparam REG_MTIME      = 4'h4; // mtime low word
+    localparam REG_MTIMEH     = 4'h5; // mtime high word
+    localparam REG_MTIMECMP   = 4'h6; // channel n: low word at 0x6 + 2n, high word at 0x7 + 2n
+    localparam REG_CMP_STATUS = 4'hC; // mtime >= mtimecmp, one bit per channel
+    localparam REG_CAP_CTRL   = 4'hD; // capture sources and status
+    localparam REG_CAPTURE    = 4'hE; // captured mtime low word
+    localparam REG_CAPTUREH   = 4'hF; // captured mtime high word
+
+    localparam CAP_CAPTURED   = 24;   // CAP_CTRL status bits
+    localparam CAP_OVERRUN    = 25;
+
+    wire [3:0] adr = wb_adr_i[5:2];
+
+    genvar c;
+    generate
+        for (c = 0; c < CMP_CHANNELS; c++) begin : g_cmp
+            assign cmp_match[c] = mtime >= mtimecmp[c];
+        end
+    endgenerate
 
     // Wishbone Read logic
     always @(posedge clk) begin
@@ -67,12 +167,24 @@ module Timer (
             if(wb_cyc_i & wb_stb_i & !wb_we_i) begin
                 wb_ack_o <= 1'b1; // ACK on read requests
 
-                case (wb_adr_i[3:2])
-                    REG_CONTROL:   wb_dat_o <= {30'd0, flag, enable};
-                    REG_COUNTER:   wb_dat_o <= counter;
-                    REG_PRESCALER: wb_dat_o <= prescaler;
-                    REG_COMPARE:   wb_dat_o <= compare;
-                    default:       wb_dat_o <= 32'd0;
+                case (adr)
+                    REG_CONTROL:    wb_dat_o <= {29'd0, mtime_halt, flag, enable};
+                    REG_COUNTER:    wb_dat_o <= counter;
+                    REG_PRESCALER:  wb_dat_o <= prescaler;
+                    REG_COMPARE:    wb_dat_o <= compare;
+                    REG_MTIME:      wb_dat_o <= mtime[31:0];
+                    REG_MTIMEH:     wb_dat_o <= mtime[63:32];
+                    REG_CMP_STATUS: wb_dat_o <= {{(32-CMP_CHANNELS){1'b0}}, cmp_match};
+                    REG_CAP_CTRL:   wb_dat_o <= {6'd0, overrun, captured, 7'd0, cap_uart_en, cap_fall_en, cap_rise_en};
+                    REG_CAPTURE:    wb_dat_o <= capture[31:0];
+                    REG_CAPTUREH:   wb_dat_o <= capture[63:32];
+                    default: begin
+                        wb_dat_o <= 32'd0;
+                        for (int n = 0; n < CMP_CHANNELS; n++) begin
+                            if (adr == REG_MTIMECMP + 2*n)     wb_dat_o <= mtimecmp[n][31:0];
+                            if (adr == REG_MTIMECMP + 2*n + 1) wb_dat_o <= mtimecmp[n][63:32];
+                        end
+                    end
                 endcase
             end else begin
                 wb_ack_o <= 1'b0; // No ACK on other conditions
@@ -82,7 +194,7 @@ module Timer (
     end
 
     // Timer operation
-    always @(posedge clk) begin
+    always @(posedge timer_clk) begin
         if (!rst_n) begin
             counter     <= 32'd0;
             prescaler   <= 32'd0;
@@ -108,8 +220,8 @@ module Timer (
             end
 
             // Wishbone writes
-            if (wb_cyc_i & wb_stb_i & wb_we_i) begin
-                case (wb_adr_i[3:2]) // word addressing
+            if (wb_write) begin
+                case (adr) // word addressing
                     REG_CONTROL: begin
                         enable <= wb_dat_i[0];
                         if (wb_dat_i[1]) flag <= 1'b0; // write 1 to clear flag
@@ -117,10 +229,71 @@ module Timer (
                     REG_COUNTER: counter   <= wb_dat_i;
                     REG_PRESCALER: prescaler <= wb_dat_i;
                     REG_COMPARE: compare   <= wb_dat_i;
+                    default: ;
                 endcase
             end
         end
     end
 
+    // mtime and mtimecmp
+    always @(posedge mtime_clk) begin
+        if (!rst_n) begin
+            mtime_halt  <= 1'b0;
+            mtime       <= 64'd0;
+            for (int n = 0; n < CMP_CHANNELS; n++) mtimecmp[n] <= 64'hFFFF_FFFF_FFFF_FFFF;
+        end else begin
+            // A write to either half replaces that half and skips the increment
+            if (!mtime_halt && !(wb_write && (adr == REG_MTIME || adr == REG_MTIMEH))) mtime <= mtime + 64'd1;
+
+            // Wishbone writes
+            if (wb_write) begin
+                case (adr)
+                    REG_CONTROL: mtime_halt <= wb_dat_i[2];
+                    REG_MTIME:   mtime[31:0]  <= wb_dat_i;
+                    REG_MTIMEH:  mtime[63:32] <= wb_dat_i;
+                    default: begin
+                        for (int n = 0; n < CMP_CHANNELS; n++) begin
+                            if (adr == REG_MTIMECMP + 2*n)     mtimecmp[n][31:0]  <= wb_dat_i;
+                            if (adr == REG_MTIMECMP + 2*n + 1) mtimecmp[n][63:32] <= wb_dat_i;
+                        end
+                    end
+                endcase
+            end
+        end
+    end
+
+    // Event capture (ungated: the events can arrive while the counters are stopped)
+    wire cap_event = |(gpio_rise & cap_rise_en) | |(gpio_fall & cap_fall_en) | (uart_rx_start & cap_uart_en);
+    wire cap_write = wb_write && adr == REG_CAP_CTRL;
+    wire cap_clear = cap_write && wb_dat_i[CAP_CAPTURED];
+
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            cap_rise_en <= 8'd0;
+            cap_fall_en <= 8'd0;
+            cap_uart_en <= 1'b0;
+            captured    <= 1'b0;
+            overrun     <= 1'b0;
+            capture     <= 64'd0;
+        end else begin
+            if (cap_write) begin
+                cap_rise_en <= wb_dat_i[7:0];
+                cap_fall_en <= wb_dat_i[15:8];
+                cap_uart_en <= wb_dat_i[16];
+                if (wb_dat_i[CAP_CAPTURED]) captured <= 1'b0;
+                if (wb_dat_i[CAP_OVERRUN])  overrun  <= 1'b0;
+            end
+
+            if (cap_event) begin
+                if (!captured || cap_clear) begin
+                    capture  <= mtime;
+                    captured <= 1'b1;
+                end else begin
+                    overrun  <= 1'b1;
+                end
+            end
+        end
+    end
+
 
 endmodule
@@ -38,13 +38,22 @@
     Address mapping:
     - 0x00: TXDATA (Transmit data register)
     - 0x04: RXDATA (Receive data register)
-    - 0x08: CTRL   (Control register)
+    - 0x08: CTRL   (Control/status register, only TX_EN/RX_EN writable)
     - 0x0C: BAUD   (Baud register)
 
     Control Register Bits:
     - Bit 0: TX_BUSY (Transmitter busy flag - readonly)
     - Bit 1: FULL_BUFF (Transmitter full buffer flag - readonly)
-    - Bit 2: RX_READY (Receiver ready flag - readonly)
+    - Bit 2: RX_BUSY (Receiver busy flag - readonly)
+    - Bit 3: RX_READY (Receiver ready flag - readonly)
+    - Bit 4: TX_EN (Transmitter enable - read/write, reset 1)
+    - Bit 5: RX_EN (Receiver enable - read/write, reset 1)
+
+    The transmitter and the receiver run on their own gated clocks
+    (Clock_gate). The transmitter clock only runs while TX_EN is set and a
+    byte is pending or being sent, the receiver state machine while RX_EN is
+    set and a frame is being received. Clearing RX_EN also stops the RXD
+    synchronizer, so no start bit is detected while the receiver is off.
 
     Baud rate is set in the BAUD register, which is a 16-bit value
     that determines the number of clock cycles per bit.
@@ -78,19 +87,23 @@ module UART (
 
     // UART interface
     output reg txd,
-    input wire rxd
+    input wire rxd,
+
+    output wire rx_start_o      // Start bit of a frame detected (one-cycle pulse, Timer capture)
 );
 
 
     localparam TXDATA = 2'b00; // Transmit data register
     localparam RXDATA = 2'b01; // Receive data register - READ ONLY
-    localparam CTRL   = 2'b10; // Control register  - READ ONLY
+    localparam CTRL   = 2'b10; // Control register  - READ ONLY except TX_EN/RX_EN
     localparam BAUD   = 2'b11; // Baud rate register
 
     localparam TX_BUSY      = 0; // Transmitter busy flag
     localparam FULL_BUFF    = 1; // Transmitter full buffer flag
     localparam RX_BUSY      = 2; // Receiver busy flag
     localparam RX_READY     = 3; // Receiver ready flag
+    localparam TX_EN        = 4; // Transmitter enable
+    localparam RX_EN        = 5; // Receiver enable
 
     reg [31:0] uart_reg[3:0]; // 4 registers for UART
 
@@ -118,6 +131,35 @@ module UART (
     reg         rxd_prev;       // Previous value of RXD signal
     reg [15:0]  baud_counter_rx;   // Counter for baud rate timing
 
+    wire        tx_en = uart_reg[CTRL][TX_EN];
+    wire        rx_en = uart_reg[CTRL][RX_EN];
+    wire        rx_start = rxd_prev && !rxd_sync; // Falling edge on RXD
+
+    assign rx_start_o = rx_en && rx_state == S_RX_IDLE && rx_start;
+
+    ////////////////////////////////////////////////////
+    // Clock gates
+    ////////////////////////////////////////////////////
+    wire tx_clk, rx_clk, rx_sm_clk;
+
+    Clock_gate tx_cg (
+        .clk(clk),
+        .en((tx_en & (tx_state != S_TX_IDLE || uart_reg[CTRL][FULL_BUFF])) | ~rst_n),
+        .gclk(tx_clk)
+    );
+
+    Clock_gate rx_cg (
+        .clk(clk),
+        .en(rx_en | ~rst_n),
+        .gclk(rx_clk)
+    );
+
+    Clock_gate rx_sm_cg (
+        .clk(clk),
+        .en((rx_en & (rx_state != S_RX_IDLE || rx_start)) | ~rst_n),
+        .gclk(rx_sm_clk)
+    );
+
     ////////////////////////////////////////////////////
     // Wishbone interface handling
     ////////////////////////////////////////////////////
@@ -125,7 +167,7 @@ module UART (
         if (!rst_n) begin
             uart_reg[0] <= 32'b0;
             uart_reg[1] <= 32'b0;
-            uart_reg[2] <= 32'b0;
+            uart_reg[2] <= (32'b1 << TX_EN) | (32'b1 << RX_EN);
             uart_reg[3] <= 32'b0;
             wb_ack_o <= 1'b0;
         end else begin
@@ -148,6 +190,13 @@ module UART (
                         uart_reg[CTRL][FULL_BUFF] <= 1'b1; // Set full buffer flag when writing to TXDATA
                     end
 
+                end else if (wb_we_i && wb_adr_i[3:2] == CTRL) begin
+                    // Only the enable bits are writable
+                    if (wb_sel_i[0]) begin
+                        uart_reg[CTRL][TX_EN] <= wb_dat_i[TX_EN];
+                        uart_reg[CTRL][RX_EN] <= wb_dat_i[RX_EN];
+                    end
+
                 end else begin
                     // Read operation
                     wb_dat_o <= uart_reg[wb_adr_i[3:2]];  // Read from UART register
@@ -160,7 +209,8 @@ module UART (
             end
 
 
-            case(tx_state)
+            // Status flags follow the transmitter and receiver only while they are enabled
+            if (tx_en) case(tx_state)
                 S_TX_IDLE:begin
                     if (uart_reg[CTRL][FULL_BUFF]) begin
                         uart_reg[CTRL][TX_BUSY]     <= 1'b1;
@@ -181,9 +231,9 @@ module UART (
             endcase
 
 
-            case(rx_state)
+            if (rx_en) case(rx_state)
                 S_RX_IDLE: begin
-                    if (rxd_prev && !rxd_sync) begin // Start bit detected
+                    if (rx_start) begin // Start bit detected
                         uart_reg[CTRL][RX_BUSY] <= 1'b1;
                     end
                 end
@@ -214,14 +264,14 @@ module UART (
 
 
 
-    always @(posedge clk) begin
+    always @(posedge tx_clk) begin
         if (!rst_n) begin
             tx_state                 <= S_TX_IDLE;
             tx_buffer                <= 8'b0;
             tx_bit_count             <= 4'b0;
             txd                      <= 1'b1; 
             baud_counter_tx             <= 16'b0; 
-        end else begin
+        end else if (tx_en) begin
 
 
 
@@ -291,12 +341,12 @@ module UART (
 
     // Synchronize the RXD signal to the clock domain
     reg [1:0]   rx_crc;
-    always_ff @(posedge clk) begin
+    always_ff @(posedge rx_clk) begin
         if(!rst_n) begin
             rxd_sync <= 1'b0; // Reset synchronized RXD signal
             rx_crc <= 2'b0;
             rxd_prev <= 1'b0;
-        end else begin
+        end else if (rx_en) begin
             rx_crc <= {rx_crc[0], rxd};
             rxd_sync <= rx_crc[1]; // Synchronize RXD signal
             rxd_prev <= rxd_sync; // Store previous value of RXD signal 
@@ -305,18 +355,18 @@ module UART (
 
 
     // Receiver state machine
-    always @(posedge clk) begin
+    always @(posedge rx_sm_clk) begin
         if (!rst_n) begin
             rx_state <= S_RX_IDLE;
             rx_buffer <= 8'b0;
             rx_bit_count <= 3'b0;
-        end else begin
+        end else if (rx_en) begin
 
 
 
             case (rx_state)
                 S_RX_IDLE: begin
-                    if (rxd_prev && !rxd_sync) begin // Start bit detected
+                    if (rx_start) begin // Start bit detected
                         rx_bit_count <= 3'b0;
                         rx_buffer <= 8'b0;
                         rx_state <= S_RX_START;
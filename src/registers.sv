@@ -35,13 +35,15 @@ module RVCPU_registers (
 
     input   wire [4:0]  r_addr1,  
     input   wire [4:0]  r_addr2,
+    input   wire [4:0]  r_addr3,  // rd: accumulator of the MAC instructions
 
     input   wire        w_en,
     input   wire [4:0]  w_addr,
     input   wire [31:0] w_data,
 
     output  wire [31:0] out1,  
-    output  wire [31:0] out2  
+    output  wire [31:0] out2,
+    output  wire [31:0] out3
 );
 
     reg [31:0] registers[0:31] /*verilator public_flat_rw*/;
@@ -62,5 +64,6 @@ module RVCPU_registers (
     
     assign out1 = registers[r_addr1];
     assign out2 = registers[r_addr2];
+    assign out3 = registers[r_addr3];
 
 endmodule
\ No newline at end of file
@@ -0,0 +1,21 @@
+CPU_TOP.sv
+RVCPU.sv
+Instr_mem.sv
+RAM.sv
+registers.sv
+ALU.sv
+CPU_control.sv
+ALU_dec.sv
+Instr_dec.sv
+Imm_extend.sv
+Mem_dec.sv
+mux4to1.sv
+Wishbone_master.sv
+GPIO.sv
+JTAG.sv
+Programming_controller.sv
+Muldiv.sv
+UART.sv
+Timer.sv
+Clock_gate.sv
+Interconnect.sv
@@ -12,7 +12,7 @@
 # Design name should match the top-level module name in the HDL file.
 #  JTAG.sv Programming_controller.sv GPIO.sv
 
-set HDL_FILES [list CPU_TOP.sv RVCPU.sv ALU.sv ALU_dec.sv CPU_control.sv Imm_extend.sv Instr_dec.sv Mem_dec.sv mux4to1.sv registers.sv Wishbone_master.sv JTAG.sv Programming_controller.sv GPIO.sv Muldiv.sv RAM.sv Instr_mem.sv UART.sv Timer.sv]
+set HDL_FILES [list CPU_TOP.sv RVCPU.sv ALU.sv ALU_dec.sv CPU_control.sv Imm_extend.sv Instr_dec.sv Mem_dec.sv mux4to1.sv registers.sv Wishbone_master.sv JTAG.sv Programming_controller.sv GPIO.sv Muldiv.sv RAM.sv Instr_mem.sv UART.sv Timer.sv Clock_gate.sv Interconnect.sv]
 set _HDL_DIRECTORY ./SRC
 set DESIGN SYSTEM_TOP 
 
@@ -20,6 +20,10 @@ set DESIGN SYSTEM_TOP
 set CLOCK_NAME clk
 set CLOCK_PERIOD_ps 4000
 
+# Optional switching activity for report_power (SAIF written by tests/benchmarks with +saif=<file>).
+# Leave empty to use the default toggle rates.
+set SAIF_FILE ""
+
 set GEN_EFF medium
 set MAP_OPT_EFF high
 
@@ -54,7 +58,7 @@ set_db use_tiehilo_for_const duplicate;
 # Read HDL files from the specified directory
 # Use option -vhd for VHDL files, -verilog for Verilog files, or -sv for SystemVerilog files.
 
-read_hdl -sv ${HDL_FILES}
+read_hdl -sv -define SYNTHESIS ${HDL_FILES}
 elaborate ${DESIGN}
 
 check_design -unresolved
@@ -163,6 +167,9 @@ report_dp > ${_REPORTS_PATH}/${DESIGN}_datapath_incr.rpt
 report_messages > ${_REPORTS_PATH}/${DESIGN}_messages.rpt
 report_gates > ${_REPORTS_PATH}/${DESIGN}_gates.rpt
 report_timing > ${_REPORTS_PATH}/${DESIGN}_timing.rpt
+if {$SAIF_FILE ne ""} {
+    read_saif -instance ${DESIGN} ${SAIF_FILE}
+}
 report_power > ${_REPORTS_PATH}/${DESIGN}_power.rpt
 
 
@@ -351,6 +351,8 @@ streamOut OUTPUTS/${DESIGN}.gds -structureName ${DESIGN} \
 # read_activity_file -reset
 # set_switching_activity -clock clk -scale_factor 2.5
 # read_activity_file -format VCD -scope CPU_tb/dut -start 311000 -end 411900 -block {} SIM/waveform.vcd
+# SAIF from tests/benchmarks (+saif=<file>), rooted at SYSTEM_TOP. -block is the SYSTEM_TOP instance inside TOP.
+# read_activity_file -format SAIF -scope SYSTEM_TOP -block <SYSTEM_TOP instance> DATA/activity.saif
 # set_power -reset
 # set_powerup_analysis -reset
 # set_dynamic_power_simulation -reset
@@ -8,6 +8,12 @@
  * the test reports a timeout and exits. A VCD waveform ("waveform.vcd")
  * is produced for post-simulation inspection.
  *
+ * It then backdoor loads `gpio_test.bin` (gpio_test.S), a self-checking
+ * program for the SET/CLR/TGL aliases and the RISE/FALL edge capture, and
+ * runs it until the TOHOST mailbox is written. While the program clears
+ * RISE[0] with back-to-back stores, the testbench sends edges on gpio_in[0]
+ * and checks every cycle that an edge arriving with the clear is kept.
+ *
  * @author ridoluc
  * @date 2025-11
  */
@@ -16,11 +22,25 @@
 #include "verilated.h"
 #include <verilated_vcd_c.h> 
 #include "VSYSTEM_TOP___024root.h"
+#include "../common/host_exit.h"
+#include "../common/uart_boot.h"
 #include <iostream>
 #include <iomanip> 
 #include <vector>
 #include <cassert>
 
+#ifdef USE_DPI_RAM
+#include "../common/sparse_mem.h"
+#endif
+
+#define GPIO_IMAGE          "./gpio_test.bin"
+#define GPIO_TEST_CYCLES    20000
+#define IMEM_WORDS          256     // 1 KB, see gcc-toolchain/linker.ld
+
+#define GPIO_RISE           0x1C    // Edge capture register
+#define REQ_EDGES           0x40    // Requests of gpio_test.S on OUT
+#define REQ_RACE            0x80
+
 vluint64_t main_time = 0;
 
 VerilatedVcdC* tfp = nullptr; 
@@ -41,15 +61,100 @@ void clk_tick(VSYSTEM_TOP* top) {
     main_time++;
 }
 
+// Runs gpio_test.bin and answers its requests. Returns the number of failed checks.
+int run_gpio_test(VSYSTEM_TOP* top) {
+    std::vector<uint32_t> image = uart_boot::read_image(GPIO_IMAGE);
+    if (image.empty() || image.size() > IMEM_WORDS) {
+        std::cout << "Cannot use image " << GPIO_IMAGE << std::endl;
+        return 1;
+    }
+    for (uint32_t i = 0; i < IMEM_WORDS; i++)
+        top->rootp->SYSTEM_TOP__DOT__instruction_memory__DOT__instruction_memory[i] = i < image.size() ? image[i] : 0;
+
+    top->gpio_in = 0;
+    top->rst_n = 0;
+    clk_tick(top);
+    top->rst_n = 1;
+    clk_tick(top);
+
+    auto* root = top->rootp;
+    bool edges_sent = false;
+    int races = 0;          // Clears of RISE[0] in the same cycle as an edge
+    int clears = 0;         // Clears without an edge
+    int errors = 0;
+    uint32_t race_cycle = 0;
+    vluint64_t start_time = main_time;
+
+    while (!host_finished(top) && main_time - start_time < GPIO_TEST_CYCLES) {
+        if (top->gpio_out == REQ_EDGES && !edges_sent) {
+            for (int i = 0; i < 5; i++) clk_tick(top);
+            top->gpio_in = 0x5A;    // Rising 0x5A
+            for (int i = 0; i < 10; i++) clk_tick(top);
+            top->gpio_in = 0x42;    // Falling 0x18
+            edges_sent = true;
+            continue;
+        }
+
+        // Rising edges on gpio_in[0] 2 and 3 cycles apart, so they line up with
+        // the clears whatever the store rate of the CPU
+        if (top->gpio_out == REQ_RACE) {
+            top->gpio_in = 0x42 | ((race_cycle % 5 == 0 || race_cycle % 5 == 2) ? 1 : 0);
+            race_cycle++;
+        } else if (race_cycle) {
+            top->gpio_in = 0x42;
+        }
+
+        bool clear = root->SYSTEM_TOP__DOT__gpio__DOT__wb_write
+                  && (root->SYSTEM_TOP__DOT__o_wb_address & 0x3C) == GPIO_RISE
+                  && (root->SYSTEM_TOP__DOT__o_wb_data & 1);
+        bool edge = root->SYSTEM_TOP__DOT__gpio__DOT__in_rise & 1;
+        clk_tick(top);
+        bool kept = root->SYSTEM_TOP__DOT__gpio__DOT__edge_rise & 1;
+
+        if (clear && edge) {
+            races++;
+            if (!kept) {
+                std::cout << "FAIL: T: " << (int)main_time << " edge lost to a RISE clear in the same cycle" << std::endl;
+                errors++;
+            }
+        } else if (clear) {
+            clears++;
+            if (kept) {
+                std::cout << "FAIL: T: " << (int)main_time << " RISE[0] not cleared" << std::endl;
+                errors++;
+            }
+        }
+    }
+
+    if (!host_finished(top)) {
+        std::cout << "GPIO test: no exit code after " << GPIO_TEST_CYCLES << " cycles" << std::endl;
+        return errors + 1;
+    }
+    int code = host_exit_code(top);
+    std::cout << "GPIO test: exit code " << code << " after " << (main_time - start_time) << " cycles, "
+              << races << " clears with an edge, " << clears << " without" << std::endl;
+    if (code != 0) {
+        std::cout << "FAIL: GPIO test (the exit code is the failed check in gpio_test.S)" << std::endl;
+        errors++;
+    }
+    if (races == 0 || clears == 0) {
+        std::cout << "FAIL: the same-cycle edge and clear case was not exercised" << std::endl;
+        errors++;
+    }
+    return errors;
+}
+
 int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
     Verilated::traceEverOn(true); // Enable tracing
     VSYSTEM_TOP* top = new VSYSTEM_TOP;
     
 
+#if VM_TRACE
     tfp = new VerilatedVcdC; // Create trace object
     top->trace(tfp, 99);     // Trace 99 levels of hierarchy
     tfp->open("waveform.vcd"); // Open VCD file
+#endif
 
     /////////  Reset the system  /////////
     std::cout << "Resetting the system..." << std::endl;
@@ -77,10 +182,21 @@ int main(int argc, char** argv) {
 
     }
 
+    int errors = run_gpio_test(top);
+    std::cout << (errors ? "GPIO test FAILED" : "GPIO test passed") << std::endl;
+
 
+#ifdef USE_DPI_RAM
+    // Data memory footprint and per-page access counters of the sparse RAM model
+    sparse_mem().report(std::cout);
+#endif
 
-    tfp->close(); // Close VCD file
-    delete tfp;
+
+    if (tfp) {
+        tfp->close(); // Close VCD file
+        delete tfp;
+    }
+    top->final();
     delete top;
-    return 0;
+    return errors ? 1 : 0;
 }
@@ -0,0 +1,208 @@
+/**
+ * @file Interconnect_tb.cpp
+ * @brief Testbench for the Wishbone interconnect in VSYSTEM_TOP (Verilator).
+ *
+ * Backdoor loads `bus_test.bin` (bus_test.S), a self-checking program with
+ * back-to-back loads across the RAM, IMEM and peripheral slaves, loads right
+ * after stores and accesses to the RAM hidden under the peripheral block,
+ * and runs it until the TOHOST mailbox is written.
+ *
+ * On every cycle the testbench checks the bus against the memory map of
+ * CPU_TOP.sv:
+ * - the strobe goes to the one slave decoded from the address (the
+ *   peripherals win over the RAM window they sit in)
+ * - a read strobes its slave once and is acknowledged once, after the
+ *   slave cycle plus the response slices of that slave
+ *
+ * Build with REGISTERED_RESPONSES defined (make REGISTERED_RESPONSES=1, or
+ * the Interconnect_reg_tb CMake target) to check the one-slice peripherals.
+ */
+
+#include "VSYSTEM_TOP.h"
+#include "verilated.h"
+#include <verilated_vcd_c.h>
+#include "VSYSTEM_TOP___024root.h"
+#include "../common/host_exit.h"
+#include "../common/uart_boot.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define BUS_IMAGE           "./bus_test.bin"
+#define BUS_TEST_CYCLES     5000
+#define IMEM_WORDS          256     // 1 KB, see gcc-toolchain/linker.ld
+
+// Slave order and latencies of the memory map table in CPU_TOP.sv
+enum { S_RAM, S_IMEM, S_GPIO, S_UART, S_TIMER, S_HOST, S_EXT, N_SLAVES };
+
+static const char* SLAVE_NAME[N_SLAVES] = { "RAM", "IMEM", "GPIO", "UART", "Timer", "HOST", "EXT" };
+
+#ifdef REGISTERED_RESPONSES
+#define PERIPH_LATENCY      1
+#else
+#define PERIPH_LATENCY      0
+#endif
+
+static const int SLAVE_LATENCY[N_SLAVES] = {
+    0, 0, PERIPH_LATENCY, PERIPH_LATENCY, PERIPH_LATENCY, PERIPH_LATENCY, PERIPH_LATENCY
+};
+
+vluint64_t main_time = 0;
+
+VerilatedVcdC* tfp = nullptr;
+
+void clk_tick(VSYSTEM_TOP* top) {
+    top->eval();
+    if (tfp && main_time > 0) tfp->dump(main_time*10-2);
+    top->clk = 1;
+    top->eval();
+    if (tfp) tfp->dump(main_time*10);
+
+    top->clk = 0;
+    top->eval();
+    if (tfp) {
+        tfp->dump(main_time*10+5);
+        tfp->flush();
+    }
+    main_time++;
+}
+
+// Slave selected by the memory map for an address, -1 when unmapped
+int decode(uint32_t addr) {
+    if (addr & 0x80000000) return S_IMEM;
+    switch (addr & ~0x3Fu) {
+        case 0x00: return S_GPIO;
+        case 0x40: return S_UART;
+        case 0x80: return S_TIMER;
+        case 0xC0: return S_HOST;
+    }
+    if ((addr & ~0xFFFFFu) == 0x00000000) return S_RAM;
+    if ((addr & ~0xFFFFFu) == 0x10000000) return S_EXT;
+    return -1;
+}
+
+std::string hex(uint32_t v) {
+    std::ostringstream s;
+    s << "0x" << std::hex << std::setw(8) << std::setfill('0') << v;
+    return s.str();
+}
+
+// Runs bus_test.bin and checks the decode and the read handshakes. Returns the number of errors.
+int run_bus_test(VSYSTEM_TOP* top) {
+    std::vector<uint32_t> image = uart_boot::read_image(BUS_IMAGE);
+    if (image.empty() || image.size() > IMEM_WORDS) {
+        std::cout << "Cannot use image " << BUS_IMAGE << std::endl;
+        return 1;
+    }
+    for (uint32_t i = 0; i < IMEM_WORDS; i++)
+        top->rootp->SYSTEM_TOP__DOT__instruction_memory__DOT__instruction_memory[i] = i < image.size() ? image[i] : 0;
+
+    top->rst_n = 0;
+    clk_tick(top);
+    top->rst_n = 1;
+    clk_tick(top);
+
+    auto* root = top->rootp;
+    int reads[N_SLAVES] = {};
+    int writes[N_SLAVES] = {};
+    int errors = 0;
+    int read_slave = -1;            // Read waiting for its ack
+    vluint64_t read_time = 0;
+    vluint64_t start_time = main_time;
+
+    while (!host_finished(top) && main_time - start_time < BUS_TEST_CYCLES) {
+        bool     stb  = root->SYSTEM_TOP__DOT__o_wb_stb && root->SYSTEM_TOP__DOT__o_wb_cyc;
+        bool     we   = root->SYSTEM_TOP__DOT__o_wb_we;
+        uint32_t addr = root->SYSTEM_TOP__DOT__o_wb_address;
+        uint32_t s_stb = root->SYSTEM_TOP__DOT__slave_stb;
+        bool     ack  = root->SYSTEM_TOP__DOT__i_wb_ack;
+
+        if (ack) {
+            if (read_slave < 0) {
+                std::cout << "FAIL: T: " << (int)main_time << " ack without a read" << std::endl;
+                errors++;
+            } else {
+                int latency = main_time - read_time;
+                if (latency != 1 + SLAVE_LATENCY[read_slave]) {
+                    std::cout << "FAIL: T: " << (int)main_time << " " << SLAVE_NAME[read_slave]
+                              << " read acknowledged after " << latency << " cycles, expected "
+                              << 1 + SLAVE_LATENCY[read_slave] << std::endl;
+                    errors++;
+                }
+                read_slave = -1;
+            }
+        }
+
+        // The CPU holds the strobe until the ack: only the first cycle of a read reaches the slave
+        if (stb && read_slave < 0 && !ack) {
+            int slave = decode(addr);
+            uint32_t expected = slave < 0 ? 0 : 1u << slave;
+            if (s_stb != expected) {
+                std::cout << "FAIL: T: " << (int)main_time << " address " << hex(addr)
+                          << " strobes slaves " << hex(s_stb) << ", expected " << hex(expected) << std::endl;
+                errors++;
+            }
+            if (slave >= 0 && we) {
+                writes[slave]++;
+            } else if (slave >= 0) {
+                reads[slave]++;
+                read_slave = slave;
+                read_time = main_time;
+            }
+        } else if (s_stb) {
+            std::cout << "FAIL: T: " << (int)main_time << " strobe " << hex(s_stb)
+                      << (stb ? " repeated while a read is pending" : " without a bus cycle") << std::endl;
+            errors++;
+        }
+
+        clk_tick(top);
+    }
+
+    if (!host_finished(top)) {
+        std::cout << "Interconnect test: no exit code after " << BUS_TEST_CYCLES << " cycles" << std::endl;
+        return errors + 1;
+    }
+    int code = host_exit_code(top);
+    std::cout << "Interconnect test: exit code " << code << " after " << (main_time - start_time)
+              << " cycles, peripheral latency " << PERIPH_LATENCY << std::endl;
+    for (int s = 0; s < N_SLAVES; s++)
+        std::cout << "  " << std::left << std::setw(6) << SLAVE_NAME[s] << std::right
+                  << std::setw(4) << reads[s] << " reads " << std::setw(4) << writes[s] << " writes" << std::endl;
+
+    if (code != 0) {
+        std::cout << "FAIL: Interconnect test (the exit code is the failed check in bus_test.S)" << std::endl;
+        errors++;
+    }
+    for (int s = S_RAM; s <= S_HOST; s++) {
+        if (reads[s] == 0) {
+            std::cout << "FAIL: no read from " << SLAVE_NAME[s] << std::endl;
+            errors++;
+        }
+    }
+    return errors;
+}
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+    Verilated::traceEverOn(true); // Enable tracing
+    VSYSTEM_TOP* top = new VSYSTEM_TOP;
+
+#if VM_TRACE
+    tfp = new VerilatedVcdC; // Create trace object
+    top->trace(tfp, 99);     // Trace 99 levels of hierarchy
+    tfp->open("waveform.vcd"); // Open VCD file
+#endif
+
+    int errors = run_bus_test(top);
+    std::cout << (errors ? "Interconnect test FAILED" : "Interconnect test passed") << std::endl;
+
+    if (tfp) {
+        tfp->close(); // Close VCD file
+        delete tfp;
+    }
+    top->final();
+    delete top;
+    return errors ? 1 : 0;
+}
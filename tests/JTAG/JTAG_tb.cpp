@@ -7,6 +7,12 @@
 #include <iomanip> 
 #include <vector>
 #include <cassert>
+
+#include "../common/host_exit.h"
+
+#ifdef USE_DPI_RAM
+#include "../common/sparse_mem.h"
+#endif
 #include <fstream>
 #include <vector>
 #include <cstdint>
@@ -25,6 +31,7 @@
 #define DR_W (ADDR_W + DATA_W)
 
 #define MEM_FILE "./instr_mem.bin"
+#define RUN_CYCLES 5000     // Limit for the program loaded over JTAG
 
 #define ASSERT_AND_DUMP(cond) \
     do { \
@@ -193,9 +200,11 @@ int main(int argc, char** argv) {
     VSYSTEM_TOP* top = new VSYSTEM_TOP;
     
 
+#if VM_TRACE
     tfp = new VerilatedVcdC; // Create trace object
     top->trace(tfp, 99);     // Trace 99 levels of hierarchy
     tfp->open("waveform.vcd"); // Open VCD file
+#endif
 
     reset(top);
 
@@ -302,17 +311,32 @@ int main(int argc, char** argv) {
     std::cout << "Controller state transitions are correct." << std::endl;
 
     
-    // Execute the code
+    // Execute the code until it writes TOHOST or ends on its self-jump
     std::cout << "Running the CPU..." << std::endl;
-    for (size_t i = 0; i < 1000; i++) clk_tick(top);
+    uint64_t cycles = host_run(top, [&]() { clk_tick(top); }, RUN_CYCLES);
+    bool finished = host_finished(top);
 
     // Print here any outputs or final states as needed
     std::cout << "GPIO Output: " << std::bitset<8>(top->gpio_out) << " (" << (int)top->gpio_out << ")" << std::endl;
+    if (finished) {
+        std::cout << "Exit code: " << host_exit_code(top) << " after " << cycles << " cycles" << std::endl;
+    } else {
+        std::cout << "Program did not finish within " << RUN_CYCLES << " cycles" << std::endl;
+    }
 
+#ifdef USE_DPI_RAM
+    // Data memory footprint and per-page access counters of the sparse RAM model
+    sparse_mem().report(std::cout);
+#endif
 
-    tfp->close(); // Close VCD file
-    delete tfp;
+
+    if (tfp) {
+        tfp->close(); // Close VCD file
+        delete tfp;
+    }
+    int errors = (!finished || host_exit_code(top) != 0) ? 1 : 0;
+    top->final();
     delete top;
-    return 0;
+    return errors;
 }
 
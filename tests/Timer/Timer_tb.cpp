@@ -4,6 +4,11 @@
  * This testbench verifies the functionality of the Timer peripheral by printing
  * the internal state of the timer at each clock cycle.    
  * Generates `waveform.vcd` when tracing is enabled.
+ *
+ * It then backdoor loads `mtime_test.bin` (mtime_test.S), a self-checking
+ * program for the 64-bit mtime, the mtimecmp channels, MTIME_HALT and event
+ * capture, and runs it until the TOHOST mailbox is written. The program asks
+ * for the capture events through the GPIO outputs (see mtime_test.S).
  * 
  * Author: ridoluc
  * Date: 2025-11
@@ -14,11 +19,18 @@
 #include "verilated.h"
 #include <verilated_vcd_c.h> // Add this line
 #include "VSYSTEM_TOP___024root.h"
+#include "../common/host_exit.h"
+#include "../common/uart_boot.h"
 #include <iostream>
 #include <iomanip> 
 #include <vector>
 #include <cassert>
 
+#define MTIME_IMAGE         "./mtime_test.bin"
+#define MTIME_TEST_CYCLES   20000
+#define UART_BIT            16      // Clock cycles per bit, UART_BIT in mtime_test.S
+#define IMEM_WORDS          256     // 1 KB, see gcc-toolchain/linker.ld
+
 vluint64_t main_time = 0;
 
 VerilatedVcdC* tfp = nullptr; 
@@ -39,15 +51,65 @@ void clk_tick(VSYSTEM_TOP* top) {
     main_time++;
 }
 
+// Runs mtime_test.bin and answers its event requests. Returns the exit code, -1 if
+// the program did not finish.
+int run_mtime_test(VSYSTEM_TOP* top) {
+    std::vector<uint32_t> image = uart_boot::read_image(MTIME_IMAGE);
+    if (image.empty() || image.size() > IMEM_WORDS) {
+        std::cout << "Cannot use image " << MTIME_IMAGE << std::endl;
+        return -1;
+    }
+    for (uint32_t i = 0; i < IMEM_WORDS; i++)
+        top->rootp->SYSTEM_TOP__DOT__instruction_memory__DOT__instruction_memory[i] = i < image.size() ? image[i] : 0;
+
+    top->gpio_in = 0;
+    top->uart_rx = 1;
+    top->rst_n = 0;
+    clk_tick(top);
+    top->rst_n = 1;
+    clk_tick(top);
+
+    UartBootUploader uart([&](bool level) { top->uart_rx = level; }, [&]() { clk_tick(top); }, UART_BIT);
+    bool gpio_sent = false;
+    bool uart_sent = false;
+    vluint64_t start_time = main_time;
+
+    while (!host_finished(top) && main_time - start_time < MTIME_TEST_CYCLES) {
+        if (top->gpio_out == 1 && !gpio_sent) {
+            // Two rising edges on gpio_in[0]: the first is captured, the second sets OVERRUN
+            for (int level : {1, 0, 1}) {
+                for (int i = 0; i < 10; i++) clk_tick(top);
+                top->gpio_in = level;
+            }
+            gpio_sent = true;
+        } else if (top->gpio_out == 2 && !uart_sent) {
+            uart.send_byte(0xFF);   // A single falling edge: the start bit
+            uart_sent = true;
+        } else {
+            clk_tick(top);
+        }
+    }
+
+    if (!host_finished(top)) {
+        std::cout << "mtime test: no exit code after " << MTIME_TEST_CYCLES << " cycles" << std::endl;
+        return -1;
+    }
+    int code = host_exit_code(top);
+    std::cout << "mtime test: exit code " << code << " after " << (main_time - start_time) << " cycles" << std::endl;
+    return code;
+}
+
 int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
     Verilated::traceEverOn(true); // Enable tracing
     VSYSTEM_TOP* top = new VSYSTEM_TOP;
     
 
+#if VM_TRACE
     tfp = new VerilatedVcdC; // Create trace object
     top->trace(tfp, 99);     // Trace 99 levels of hierarchy
     tfp->open("waveform.vcd"); // Open VCD file
+#endif
 
     /////////  Reset the system  /////////
     std::cout << "Resetting the system..." << std::endl;
@@ -58,7 +120,8 @@ int main(int argc, char** argv) {
 
     std::cout << "System reset complete." << std::endl;
 
-    while (main_time < 1000){
+    // The counter program never returns: this part is a fixed-length printout
+    while (main_time < 1000 && !host_finished(top)) {
 
         std::cout << "Time: " << main_time
                   << "\t Counter: " << top->rootp->SYSTEM_TOP__DOT__timer__DOT__counter
@@ -70,10 +133,19 @@ int main(int argc, char** argv) {
         clk_tick(top);
     }
 
+    int errors = 0;
+    if (run_mtime_test(top) != 0) {
+        std::cout << "FAIL: mtime test (the exit code is the failed check in mtime_test.S)" << std::endl;
+        errors++;
+    } else {
+        std::cout << "mtime test passed" << std::endl;
+    }
 
-
-    tfp->close(); // Close VCD file
-    delete tfp;
+    if (tfp) {
+        tfp->close(); // Close VCD file
+        delete tfp;
+    }
+    top->final();
     delete top;
-    return 0;
+    return errors ? 1 : 0;
 }
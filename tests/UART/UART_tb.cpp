@@ -5,6 +5,9 @@
  * Sends a string via `uart_rx` and captures echoed bytes from `uart_tx`.
  * Helpers: `uart_tx` (drive RX to send a byte) and `uart_rx` (sample DUT TX).
  * Commented code shows an alternative passive listener (receive until NUL).
+ * The echo firmware (main.c) never returns, so the run is not bounded by
+ * host_exit.h: it ends after the echo of the last character, and uart_rx
+ * gives up when no start bit comes within UART_RX_TIMEOUT cycles.
  * Generates `waveform.vcd` when tracing is enabled.
  * 
  * Author: ridoluc
@@ -22,6 +25,7 @@
 #include <cassert>
 
 #define UART_BAUD_COUNT 100
+#define UART_RX_TIMEOUT 1000    // Cycles to wait for the start bit of the echo
 
 vluint64_t main_time = 0;
 
@@ -55,11 +59,11 @@ bool uart_rx(VSYSTEM_TOP* top, char* _data) {
     bool prev_uart_tx = top->uart_tx;
 
     // Wait for the UART TX start signal (falling edge detection)
-    while ((prev_uart_tx == top->uart_tx || top->uart_tx == 1) && main_time - start_time < 1000) {
+    while ((prev_uart_tx == top->uart_tx || top->uart_tx == 1) && main_time - start_time < UART_RX_TIMEOUT) {
         prev_uart_tx = top->uart_tx;
         clk_tick(top); // Continue clocking until data is received
     }
-    if (main_time - start_time >= 5000) {
+    if (main_time - start_time >= UART_RX_TIMEOUT) {
         std::cerr << "UART RX Error: No start signal detected within timeout." << std::endl;
         return 0; // Error condition
     }
@@ -127,9 +131,11 @@ int main(int argc, char** argv) {
     VSYSTEM_TOP* top = new VSYSTEM_TOP;
     
 
+#if VM_TRACE
     tfp = new VerilatedVcdC; // Create trace object
     top->trace(tfp, 99);     // Trace 99 levels of hierarchy
     tfp->open("waveform.vcd"); // Open VCD file
+#endif
 
     /////////  Reset the system  /////////
     std::cout << "Resetting the system..." << std::endl;
@@ -175,8 +181,11 @@ int main(int argc, char** argv) {
 
     std::cout << "Simulation finished." << std::endl;
 
-    tfp->close(); // Close VCD file
-    delete tfp;
+    if (tfp) {
+        tfp->close(); // Close VCD file
+        delete tfp;
+    }
+    top->final();
     delete top;
     return 0;
 }
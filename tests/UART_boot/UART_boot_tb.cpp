@@ -0,0 +1,168 @@
+/**
+ * @file UART_boot_tb.cpp
+ * @brief UART boot test for `SYSTEM_TOP` (Verilator).
+ *
+ * The SoC is reset with the `uart_boot` strap set, so the programming
+ * controller waits for an image on `uart_rx` (Programming_controller.sv).
+ * The strap is released right after the reset: the controller must keep the
+ * value latched in reset.
+ * The test uses the host uploader of tests/common/uart_boot.h to
+ *
+ *   1. send a frame with a corrupted data byte: the CRC check must fail and
+ *      the controller must stay in boot mode with the CPU isolated,
+ *   2. send the good frame at a different bit period (autobaud): every word
+ *      must be in the instruction memory and the controller must reset the
+ *      CPU into the new image,
+ *   3. run the CPU to the end of the program and compare the GPIO outputs
+ *      and the exit code with a second model whose instruction memory is
+ *      backdoor loaded with the same image.
+ *
+ *     ./UART_boot_tb                          image.bin at 16 cycles per bit
+ *     ./UART_boot_tb +bit=4 +image=prog.bin   fastest rate of the loader
+ *
+ * `instr_mem.bin` (the `$readmemb` preload) only holds a self-jump, so the
+ * CPU can only produce the expected outputs from the uploaded image.
+ */
+
+#include "VSYSTEM_TOP.h"
+#include "verilated.h"
+#include "VSYSTEM_TOP___024root.h"
+#include "../common/host_exit.h"
+#include "../common/uart_boot.h"
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define IMAGE_FILE      "./image.bin"
+#define BAD_BIT_CYCLES  100     // Bit period of the corrupted frame
+#define BIT_CYCLES      16      // Bit period of the good frame (+bit=)
+#define RUN_CYCLES      5000
+#define IMEM_WORDS      256     // 1 KB, see gcc-toolchain/linker.ld
+
+#define S_NORMAL_OPS    0       // Programming_controller states
+#define S_UART_BOOT     7
+
+
+class Soc {
+public:
+    Soc() : contextp(new VerilatedContext), top(new VSYSTEM_TOP(contextp.get())) {
+        top->uart_rx = 1;
+        top->eval();
+    }
+    ~Soc() { top->final(); }
+
+    void tick() {
+        top->clk = 1;
+        top->eval();
+        top->clk = 0;
+        top->eval();
+    }
+
+    void reset(bool uart_boot) {
+        top->uart_boot = uart_boot;
+        top->rst_n = 0;
+        tick();
+        tick();
+        top->rst_n = 1;
+    }
+
+    uint32_t state() { return top->rootp->SYSTEM_TOP__DOT__prog_ctrl__DOT__state; }
+    bool crc_error() { return top->rootp->SYSTEM_TOP__DOT__prog_ctrl__DOT__uart_boot_ld__DOT__crc_error; }
+    uint32_t& imem(uint32_t i) { return top->rootp->SYSTEM_TOP__DOT__instruction_memory__DOT__instruction_memory[i]; }
+
+    // Run until the program writes TOHOST or ends on its self-jump, or max_cycles
+    uint64_t run(uint64_t max_cycles) { return host_run(top.get(), [this]() { tick(); }, max_cycles); }
+
+    std::unique_ptr<VerilatedContext> contextp;
+    std::unique_ptr<VSYSTEM_TOP> top;
+};
+
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+
+    std::string image_file = IMAGE_FILE;
+    uint32_t bit_cycles = BIT_CYCLES;
+    const char* arg;
+    if (*(arg = Verilated::commandArgsPlusMatch("image="))) image_file = arg + 7;
+    if (*(arg = Verilated::commandArgsPlusMatch("bit="))) bit_cycles = std::strtoul(arg + 5, nullptr, 0);
+
+    std::vector<uint32_t> image = uart_boot::read_image(image_file);
+    if (image.empty() || image.size() > IMEM_WORDS) {
+        std::cerr << "Cannot use image " << image_file << std::endl;
+        return 1;
+    }
+
+    // Reference: the same image backdoor loaded
+    Soc ref;
+    for (uint32_t i = 0; i < IMEM_WORDS; i++) ref.imem(i) = i < image.size() ? image[i] : 0;
+    ref.reset(false);
+    uint64_t ref_cycles = ref.run(RUN_CYCLES);
+    if (!host_finished(ref.top.get())) {
+        std::cout << "Reference run did not finish within " << RUN_CYCLES << " cycles" << std::endl;
+        return 1;
+    }
+
+    Soc dut;
+    dut.reset(true);
+    dut.top->uart_boot = 0;     // The strap is only sampled in reset
+    UartBootUploader up([&](bool level) { dut.top->uart_rx = level; }, [&]() { dut.tick(); }, BAD_BIT_CYCLES);
+    int errors = 0;
+
+    for (int i = 0; i < 4; i++) dut.tick();
+    if (dut.state() != S_UART_BOOT) {
+        std::cout << "FAIL: controller not in UART boot mode after reset (state " << dut.state() << ")" << std::endl;
+        return 1;
+    }
+
+    // --- 1: corrupted frame ---
+    std::vector<uint8_t> bad = uart_boot::build_frame(0, image);
+    bad[9 + 4 * (image.size() / 2)] ^= 0x10;    // One data bit
+    up.send(bad);
+    for (int i = 0; i < 8; i++) dut.tick();
+    if (dut.state() != S_UART_BOOT || !dut.crc_error()) {
+        std::cout << "FAIL: corrupted frame accepted (state " << dut.state() << ")" << std::endl;
+        errors++;
+    } else {
+        std::cout << "Corrupted frame rejected, still in boot mode" << std::endl;
+    }
+
+    // --- 2: good frame, other bit period ---
+    up.set_bit_cycles(bit_cycles);
+    uint64_t start = up.cycles();
+    up.upload(0, image);
+    uint64_t upload_cycles = up.cycles() - start;
+    for (int i = 0; i < 8; i++) dut.tick();
+    std::cout << "Uploaded " << image.size() << " words in " << upload_cycles << " cycles ("
+              << bit_cycles << " cycles per bit)" << std::endl;
+
+    for (uint32_t i = 0; i < image.size(); i++) {
+        if (dut.imem(i) != image[i]) {
+            std::cout << "FAIL: IMEM word " << i << std::hex << " is 0x" << dut.imem(i)
+                      << ", expected 0x" << image[i] << std::dec << std::endl;
+            errors++;
+            break;
+        }
+    }
+    if (dut.state() != S_NORMAL_OPS || dut.crc_error()) {
+        std::cout << "FAIL: CPU not released after a good frame (state " << dut.state() << ")" << std::endl;
+        errors++;
+    }
+
+    // --- 3: run the uploaded program ---
+    uint64_t cycles = dut.run(RUN_CYCLES);
+    std::cout << "GPIO Output: " << (int)dut.top->gpio_out << " (expected " << (int)ref.top->gpio_out << ")" << std::endl;
+    std::cout << "Exit code: " << host_exit_code(dut.top.get()) << " after " << cycles << " cycles (reference: "
+              << host_exit_code(ref.top.get()) << " after " << ref_cycles << ")" << std::endl;
+    if (dut.top->gpio_out != ref.top->gpio_out || !host_finished(dut.top.get()) ||
+        host_exit_code(dut.top.get()) != host_exit_code(ref.top.get())) {
+        std::cout << "FAIL: the uploaded program does not match the backdoor loaded run" << std::endl;
+        errors++;
+    }
+
+    std::cout << (errors ? "UART boot test FAILED" : "UART boot test passed") << std::endl;
+    return errors ? 1 : 0;
+}
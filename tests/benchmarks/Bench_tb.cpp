@@ -0,0 +1,235 @@
+/**
+ * @file Bench_tb.cpp
+ * @brief Benchmark runner for `SYSTEM_TOP` (Verilator).
+ *
+ * Runs one or more program images (`$readmemb` format, as produced by
+ * gcc-toolchain/benchmarks) and reports for each of them the number of
+ * clock cycles, the number of retired instructions, the exit code (return
+ * value of main) and the value left on the GPIO outputs. Each image is loaded into the instruction memory through
+ * the public model signals, so the same executable can compare the RV32IM and
+ * the Zba/Zbb (or custom MAC) builds of a benchmark:
+ *
+ *     ./Bench_tb ../../gcc-toolchain/benchmarks/out/popcount_rv32im.bin \
+ *                ../../gcc-toolchain/benchmarks/out/popcount_zb.bin
+ *
+ * A program is considered finished as soon as it writes the TOHOST mailbox
+ * (start.S does it with the return value of main, see gcc-toolchain/host.h)
+ * or the CPU fetches a self-jump (`j .`). Without a TOHOST write the exit code
+ * is read from a0 (tests/common/host_exit.h, shared with the other testbenches). Characters written to the PUTCHAR mailbox are printed
+ * below the program results.
+ *
+ * When built with `USE_SAIF` (Makefile `SAIF=1`, CMake `-DRVCPU_SAIF=ON`) the
+ * switching activity of the run can be written as SAIF for power analysis:
+ *
+ *     ./Bench_tb +saif=popcount.saif +saif_start=1000 +saif_stop=5000 image.bin
+ *
+ * The window is given in clock cycles after reset (default: whole program).
+ * With several images the image name is appended to the SAIF file name.
+ * The total number of toggles is printed, to compare RTL changes such as
+ * clock gating (`make SAIF=1 CLOCK_GATING=1`) on the same program.
+ */
+
+#include "VSYSTEM_TOP.h"
+#include "verilated.h"
+#include "VSYSTEM_TOP___024root.h"
+#include "../common/host_exit.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+#ifdef USE_SAIF
+#include "../common/saif.h"
+#endif
+
+#define MAX_CYCLES    1000000
+#define IMEM_WORDS    256           // MEM_ADDR_WIDTH = 10 (bytes) in CPU_TOP.sv
+#define CLOCK_PERIOD_PS 4000        // Same as support/cadence_scripts/genus_synth.tcl
+
+vluint64_t main_time = 0;
+
+#ifdef USE_SAIF
+// Activity is sampled after each clock edge: tick = 2 * main_time (+1 for the high phase)
+SaifRecorder* saif = nullptr;
+#endif
+
+// No waveform: the benchmarks run on the untraced model for speed
+void clk_tick(VSYSTEM_TOP* top) {
+    top->eval();
+    top->clk = 1;
+    top->eval();
+#ifdef USE_SAIF
+    if (saif) saif->sample(2 * main_time + 1);
+#endif
+    top->clk = 0;
+    top->eval();
+    main_time++;
+#ifdef USE_SAIF
+    if (saif) saif->sample(2 * main_time);
+#endif
+}
+
+
+struct BenchResult {
+    uint64_t cycles;
+    uint64_t instructions;
+    int32_t exit_code;
+    int gpio_out;
+    bool finished;
+    std::string console;    // PUTCHAR output
+};
+
+
+bool load_image(const char* path, std::vector<uint32_t>& image) {
+    std::ifstream infile(path);
+    if (!infile) return false;
+
+    std::string line;
+    while (std::getline(infile, line)) {
+        if (line.empty()) continue;
+        image.push_back(static_cast<uint32_t>(std::stoul(line, nullptr, 2)));
+    }
+    return image.size() <= IMEM_WORDS;
+}
+
+
+// Activity window requested on the command line
+struct SaifOptions {
+    std::string file;       // Empty: no SAIF
+    uint64_t start;
+    uint64_t stop;
+};
+
+
+BenchResult run_image(const std::vector<uint32_t>& image, const SaifOptions& saif_opt) {
+    BenchResult res = {0, 0, 0, 0, false, ""};
+    VSYSTEM_TOP* top = new VSYSTEM_TOP;
+    top->eval(); // Run the initial blocks ($readmemb) before the backdoor load
+
+    // Backdoor load of the instruction memory (overrides the $readmemb image)
+    for (size_t i = 0; i < IMEM_WORDS; i++) {
+        top->rootp->SYSTEM_TOP__DOT__instruction_memory__DOT__instruction_memory[i] =
+            i < image.size() ? image[i] : 0;
+    }
+
+    top->rst_n = 0; // Assert reset
+    clk_tick(top);
+    top->rst_n = 1; // Deassert reset
+    clk_tick(top);
+
+#ifdef USE_SAIF
+    if (!saif_opt.file.empty()) saif = new SaifRecorder(top->contextp());
+    uint64_t start_time = main_time;
+#endif
+
+    // End of program and exit code as in every SYSTEM_TOP testbench (host_exit.h)
+    res.cycles = host_run(top, [&]() {
+#ifdef USE_SAIF
+        if (saif) {
+            uint64_t cycle = main_time - start_time;
+            if (cycle == saif_opt.start) saif->start(2 * main_time);
+            if (cycle == saif_opt.stop) saif->stop(2 * main_time);
+        }
+#endif
+        if (top->rootp->SYSTEM_TOP__DOT__putchar_valid) {
+            res.console += static_cast<char>(top->rootp->SYSTEM_TOP__DOT__putchar_data);
+        }
+
+        // An instruction retires on the clock edge where the CPU is not stalled.
+        // Flushed fetch slots are replaced with 0 and not counted, nor is the final self-jump.
+        if (!top->rootp->SYSTEM_TOP__DOT__cpu__DOT__stall &&
+            top->rootp->SYSTEM_TOP__DOT__cpu__DOT__instruction != 0) {
+            res.instructions++;
+        }
+        clk_tick(top);
+    }, MAX_CYCLES);
+
+    res.finished = host_finished(top);
+    res.gpio_out = top->gpio_out;
+    res.exit_code = host_exit_code(top);
+
+#ifdef USE_SAIF
+    if (saif) {
+        saif->stop(2 * main_time);     // No-op if the window already ended
+        if (!saif->bits()) {
+            std::cerr << "SAIF: no signals found, the model must be Verilated with --vpi" << std::endl;
+        } else if (!saif->write(saif_opt.file, CLOCK_PERIOD_PS / 2)) {
+            std::cerr << "SAIF: cannot write " << saif_opt.file << std::endl;
+        } else {
+            std::cout << "SAIF: " << saif_opt.file << " (" << saif->bits() << " bits, "
+                      << saif->total_toggles() << " toggles)" << std::endl;
+        }
+        delete saif;
+        saif = nullptr;
+    }
+#endif
+
+    top->final();
+    delete top;
+    return res;
+}
+
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+
+    std::cout << std::left << std::setw(48) << "Program"
+              << std::right << std::setw(12) << "Cycles"
+              << std::setw(14) << "Instructions"
+              << std::setw(8) << "CPI"
+              << std::setw(12) << "Exit"
+              << std::setw(8) << "GPIO" << std::endl;
+
+    SaifOptions saif_opt = {"", 0, UINT64_MAX};
+    const char* arg;
+    if (*(arg = Verilated::commandArgsPlusMatch("saif="))) saif_opt.file = arg + 6;
+    if (*(arg = Verilated::commandArgsPlusMatch("saif_start="))) saif_opt.start = std::strtoull(arg + 12, nullptr, 0);
+    if (*(arg = Verilated::commandArgsPlusMatch("saif_stop="))) saif_opt.stop = std::strtoull(arg + 11, nullptr, 0);
+#ifndef USE_SAIF
+    if (!saif_opt.file.empty()) std::cerr << "+saif ignored: rebuild with SAIF=1" << std::endl;
+#endif
+
+    int n_images = 0;
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] != '+') n_images++;
+    }
+
+    int errors = 0;
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '+') continue; // Verilator plusargs
+
+        std::vector<uint32_t> image;
+        if (!load_image(argv[i], image)) {
+            std::cerr << "Cannot load " << argv[i] << " (missing or larger than the instruction memory)" << std::endl;
+            errors++;
+            continue;
+        }
+
+        // One SAIF per image: <file>_<image name>.saif
+        SaifOptions image_saif = saif_opt;
+        if (!saif_opt.file.empty() && n_images > 1) {
+            std::string name = argv[i];
+            name = name.substr(name.find_last_of('/') + 1);
+            name = name.substr(0, name.find_last_of('.'));
+            std::string base = saif_opt.file.substr(0, saif_opt.file.rfind(".saif"));
+            image_saif.file = base + "_" + name + ".saif";
+        }
+
+        BenchResult res = run_image(image, image_saif);
+        std::cout << std::left << std::setw(48) << argv[i]
+                  << std::right << std::setw(12) << res.cycles
+                  << std::setw(14) << res.instructions
+                  << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (res.instructions ? double(res.cycles) / res.instructions : 0.0)
+                  << std::setw(12) << res.exit_code
+                  << std::setw(8) << res.gpio_out
+                  << (res.finished ? "" : "  <-- TIMEOUT") << std::endl;
+        if (!res.console.empty()) std::cout << res.console << std::endl;
+        if (!res.finished) errors++;
+    }
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file host_exit.h
+ * @brief End of program detection for the `SYSTEM_TOP` testbenches.
+ *
+ * A program has finished when it writes the TOHOST mailbox (CPU_TOP.sv,
+ * HOST_MAILBOX; start.S writes the return value of main) or when the CPU
+ * fetches a self-jump (`j .`), which is how images built before the mailbox
+ * end. The exit code is the TOHOST value, or a0 for those images:
+ *
+ *     uint64_t cycles = host_run(top, [&]() { clk_tick(top); }, 5000);
+ *     if (!host_finished(top)) ...            // timeout
+ *     std::cout << host_exit_code(top) << " after " << cycles << " cycles";
+ *
+ * The model must be Verilated with --public-flat-rw (all the test Makefiles
+ * and the CMake models do it). For a model whose top wraps SYSTEM_TOP, define
+ * HOST_SOC before the include to name the SYSTEM_TOP instance signals, e.g.
+ *
+ *     #define HOST_SOC(sig) EXT_WRAPPER__DOT__top__DOT__##sig
+ */
+
+#ifndef HOST_EXIT_H
+#define HOST_EXIT_H
+
+#include <cstdint>
+
+#ifndef HOST_SOC
+#define HOST_SOC(sig) SYSTEM_TOP__DOT__##sig
+#endif
+
+constexpr uint32_t HOST_SELF_JUMP = 0x0000006F;    // jal x0, 0
+
+template <class Top>
+bool host_finished(Top* top) {
+    auto* root = top->rootp;
+    return root->HOST_SOC(tohost_valid)
+        || (!root->HOST_SOC(cpu__DOT__stall) &&
+            root->HOST_SOC(cpu__DOT__instruction) == HOST_SELF_JUMP);
+}
+
+template <class Top>
+uint32_t host_exit_code(Top* top) {
+    auto* root = top->rootp;
+    return root->HOST_SOC(tohost_valid)
+         ? root->HOST_SOC(tohost_code)
+         : root->HOST_SOC(cpu__DOT__registers__DOT__registers)[10];   // a0
+}
+
+// Clocks the model until the program finishes or max_cycles have passed.
+// Returns the number of cycles run.
+template <class Top, class Tick>
+uint64_t host_run(Top* top, Tick tick, uint64_t max_cycles) {
+    uint64_t cycles = 0;
+    top->eval();
+    while (cycles < max_cycles && !host_finished(top)) {
+        tick();
+        cycles++;
+    }
+    return cycles;
+}
+
+#endif // HOST_EXIT_H
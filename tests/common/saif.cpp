@@ -0,0 +1,256 @@
+/**
+ * @file saif.cpp
+ * @brief Switching activity recorder and SAIF writer. See saif.h.
+ */
+
+#include "saif.h"
+#include "verilated.h"
+#include "verilated_syms.h"
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+static const size_t NO_PARENT = static_cast<size_t>(-1);
+
+
+// SAIF identifiers use '\' to escape the hierarchy and bit-select characters
+static std::string saif_escape(const std::string& name) {
+    std::string out;
+    for (char c : name) {
+        if (c == '[' || c == ']' || c == '/' || c == '.' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+static std::string saif_index(int i) {
+    return "\\[" + std::to_string(i) + "\\]";
+}
+
+
+SaifRecorder::SaifRecorder(VerilatedContext* contextp, const std::string& root)
+    : n_bits(0), active(false), start_tick(0), stop_tick(0) {
+    instances.push_back({root, NO_PARENT, {}, {}});
+
+    const VerilatedScopeNameMap* scopes = contextp->scopeNameMap();
+    if (!scopes) return;
+
+    for (const auto& s : *scopes) {
+        const VerilatedScope* scopep = s.second;
+        VerilatedVarNameMap* vars = scopep->varsp();
+        if (!vars) continue;
+
+        // Scope names look like "TOP.SYSTEM_TOP.cpu.alu": keep what follows the root
+        std::vector<std::string> path;
+        std::stringstream ss(scopep->name());
+        std::string item;
+        bool below_root = false;
+        while (std::getline(ss, item, '.')) {
+            if (below_root) path.push_back(item);
+            else if (item == root) below_root = true;
+        }
+        if (!below_root) continue;
+
+        size_t inst = instance_index(path);
+        for (const auto& v : *vars) {
+            const VerilatedVar& var = v.second;
+            if (var.isParam() || var.udims() > 1) continue;
+
+            uint32_t width = var.packed().elements();
+            uint32_t bytes;
+            switch (var.vltype()) {
+                case VLVT_UINT8:  bytes = 1; break;
+                case VLVT_UINT16: bytes = 2; break;
+                case VLVT_UINT32: bytes = 4; break;
+                case VLVT_UINT64: bytes = 8; break;
+                case VLVT_WDATA:  bytes = 4 * ((width + 31) / 32); break;
+                default: continue;      // Strings, pointers, reals
+            }
+
+            if (var.udims() == 1) {
+                uint32_t entries = var.unpacked().elements();
+                if (entries > MAX_ARRAY_ENTRIES) continue;
+                add_var(inst, v.first, var.datap(), var.packed().right(), width, bytes,
+                        entries, var.unpacked().low());
+            } else {
+                add_var(inst, v.first, var.datap(), var.packed().right(), width, bytes, 0, 0);
+            }
+        }
+    }
+
+    last_value.assign(nets.empty() ? 0 : nets.back().word + (nets.back().width + 31) / 32, 0);
+    toggles.assign(n_bits, 0);
+    time_high.assign(n_bits, 0);
+    last_change.assign(n_bits, 0);
+}
+
+
+size_t SaifRecorder::instance_index(const std::vector<std::string>& path) {
+    size_t inst = 0;
+    for (const std::string& name : path) {
+        size_t next = NO_PARENT;
+        for (size_t c : instances[inst].children) {
+            if (instances[c].name == name) next = c;
+        }
+        if (next == NO_PARENT) {
+            next = instances.size();
+            instances.push_back({name, inst, {}, {}});
+            instances[inst].children.push_back(next);
+        }
+        inst = next;
+    }
+    return inst;
+}
+
+
+void SaifRecorder::add_var(size_t inst, const char* name, const void* datap, int lsb,
+                           uint32_t width, uint32_t bytes, uint32_t entries, int index_base) {
+    std::string base = saif_escape(name);
+    uint32_t n = entries ? entries : 1;
+
+    for (uint32_t e = 0; e < n; e++) {
+        Net net;
+        net.instance = inst;
+        net.name     = entries ? base + saif_index(index_base + static_cast<int>(e)) : base;
+        net.data     = static_cast<const uint8_t*>(datap) + e * bytes;
+        net.width    = width;
+        net.lsb      = lsb;
+        net.bytes    = bytes;
+        net.word     = nets.empty() ? 0 : nets.back().word + (nets.back().width + 31) / 32;
+        net.bit      = n_bits;
+
+        instances[inst].nets.push_back(nets.size());
+        nets.push_back(net);
+        n_bits += width;
+    }
+}
+
+
+uint32_t SaifRecorder::load_word(const Net& n, uint32_t w) const {
+    uint32_t value = 0;
+    uint32_t offset = 4 * w;
+    uint32_t len = n.bytes - offset < 4 ? n.bytes - offset : 4;
+    std::memcpy(&value, n.data + offset, len);     // Little-endian host
+
+    uint32_t valid = n.width - 32 * w;
+    if (valid < 32) value &= (1u << valid) - 1;
+    return value;
+}
+
+
+void SaifRecorder::start(uint64_t tick) {
+    for (const Net& n : nets) {
+        for (uint32_t w = 0; w * 32 < n.width; w++) last_value[n.word + w] = load_word(n, w);
+    }
+    toggles.assign(n_bits, 0);
+    time_high.assign(n_bits, 0);
+    last_change.assign(n_bits, tick);
+    start_tick = tick;
+    stop_tick = tick;
+    active = true;
+}
+
+
+void SaifRecorder::sample(uint64_t tick) {
+    if (!active) return;
+
+    for (const Net& n : nets) {
+        for (uint32_t w = 0; w * 32 < n.width; w++) {
+            uint32_t& last = last_value[n.word + w];
+            uint32_t value = load_word(n, w);
+            uint32_t diff = value ^ last;
+            if (!diff) continue;
+
+            // Only the bits that changed are visited; time at 1 is settled on each change
+            while (diff) {
+                uint32_t b = __builtin_ctz(diff);
+                size_t idx = n.bit + 32 * w + b;
+                if (last & (1u << b)) time_high[idx] += tick - last_change[idx];
+                last_change[idx] = tick;
+                toggles[idx]++;
+                diff &= diff - 1;
+            }
+            last = value;
+        }
+    }
+}
+
+
+void SaifRecorder::stop(uint64_t tick) {
+    if (!active) return;
+
+    for (const Net& n : nets) {
+        for (uint32_t b = 0; b < n.width; b++) {
+            size_t idx = n.bit + b;
+            if (last_value[n.word + b / 32] & (1u << (b % 32))) {
+                time_high[idx] += tick - last_change[idx];
+            }
+            last_change[idx] = tick;
+        }
+    }
+    stop_tick = tick;
+    active = false;
+}
+
+
+uint64_t SaifRecorder::total_toggles() const {
+    uint64_t total = 0;
+    for (const Net& n : nets) {
+        for (uint32_t b = 0; b < n.width; b++) total += toggles[n.bit + b];
+    }
+    return total;
+}
+
+
+void SaifRecorder::write_instance(std::ostream& os, size_t inst, int indent,
+                                  uint64_t duration, uint64_t period) const {
+    const Instance& in = instances[inst];
+    std::string pad(indent, ' ');
+
+    os << pad << "(INSTANCE " << saif_escape(in.name) << "\n";
+    if (!in.nets.empty()) {
+        os << pad << "  (NET\n";
+        for (size_t ni : in.nets) {
+            const Net& n = nets[ni];
+            for (uint32_t b = 0; b < n.width; b++) {
+                uint64_t t1 = time_high[n.bit + b] * period;
+                uint64_t tc = toggles[n.bit + b];
+                std::string name = n.width > 1 ? n.name + saif_index(n.lsb + static_cast<int>(b)) : n.name;
+                os << pad << "    (" << name
+                   << " (T0 " << duration * period - t1 << ") (T1 " << t1 << ")"
+                   << " (TX 0) (TC " << tc << ") (IG 0))\n";
+            }
+        }
+        os << pad << "  )\n";
+    }
+    for (size_t c : in.children) write_instance(os, c, indent + 2, duration, period);
+    os << pad << ")\n";
+}
+
+
+bool SaifRecorder::write(const std::string& path, uint64_t tick_ps) const {
+    std::ofstream os(path);
+    if (!os) return false;
+
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%a %b %d %H:%M:%S %Y", std::localtime(&now));
+
+    uint64_t duration = stop_tick - start_tick;
+
+    os << "(SAIFILE\n"
+       << "(SAIFVERSION \"2.0\")\n"
+       << "(DIRECTION \"backward\")\n"
+       << "(DESIGN )\n"
+       << "(DATE \"" << date << "\")\n"
+       << "(VENDOR \"Verilator\")\n"
+       << "(PROGRAM_NAME \"RVCPU testbench\")\n"
+       << "(VERSION \"1.0\")\n"
+       << "(DIVIDER / )\n"
+       << "(TIMESCALE 1 ps)\n"
+       << "(DURATION " << duration * tick_ps << ")\n";
+    write_instance(os, 0, 0, duration, tick_ps);
+    os << ")\n";
+    return true;
+}
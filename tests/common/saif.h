@@ -0,0 +1,97 @@
+/**
+ * @file saif.h
+ * @brief Switching activity recorder writing SAIF files for Genus/Innovus.
+ *
+ * The recorder walks the scopes of a Verilated model (the model must be
+ * built with `--public-flat-rw --vpi` so every signal is listed in the scope
+ * tables) and keeps, for every bit below the chosen root instance, the toggle
+ * count and the time spent at 0 and at 1. Nothing is written while the model
+ * runs: at the end of the window the totals are dumped as a backward SAIF
+ * file, with the hierarchy rooted at `SYSTEM_TOP`.
+ *
+ * The harness samples the model after each clock edge (two ticks per cycle).
+ * For the synchronous design this gives the same counts as a zero-delay
+ * simulation, and the clock and the gated peripheral clocks (Clock_gate.sv)
+ * are counted as they really toggle.
+ *
+ *     SaifRecorder saif(top->contextp(), "SYSTEM_TOP");
+ *     saif.start(tick);
+ *     ...  saif.sample(tick);   after every clock edge
+ *     saif.stop(tick);
+ *     saif.write("activity.saif", CLOCK_PERIOD_PS / 2);
+ *
+ * Unpacked arrays larger than MAX_ARRAY_ENTRIES (the memories) are skipped;
+ * the register file and other small arrays are kept.
+ */
+
+#ifndef SAIF_H
+#define SAIF_H
+
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class VerilatedContext;
+
+class SaifRecorder {
+public:
+    static constexpr uint32_t MAX_ARRAY_ENTRIES = 64;
+
+    SaifRecorder(VerilatedContext* contextp, const std::string& root = "SYSTEM_TOP");
+
+    // Window control. Times are sample ticks.
+    void     start(uint64_t tick);
+    void     sample(uint64_t tick);
+    void     stop(uint64_t tick);
+    bool     recording() const { return active; }
+
+    // Write the window as SAIF. One tick lasts tick_ps.
+    bool     write(const std::string& path, uint64_t tick_ps) const;
+
+    size_t   signals() const { return nets.size(); }
+    size_t   bits() const { return n_bits; }
+    uint64_t total_toggles() const;
+
+private:
+    struct Net {
+        size_t         instance;    // Index in instances
+        std::string    name;        // SAIF name, brackets already escaped
+        const uint8_t* data;        // Value storage inside the model
+        uint32_t       width;
+        int            lsb;         // Index of bit 0 in the declaration
+        uint32_t       bytes;       // Storage size of one element
+        size_t         word;        // First 32-bit word in last_value
+        size_t         bit;         // First bit in the per-bit counters
+    };
+
+    struct Instance {
+        std::string         name;
+        size_t              parent;     // npos for the root
+        std::vector<size_t> children;
+        std::vector<size_t> nets;
+    };
+
+    std::vector<Instance> instances;
+    std::vector<Net>      nets;
+    size_t                n_bits;
+
+    std::vector<uint32_t> last_value;
+    std::vector<uint64_t> toggles;
+    std::vector<uint64_t> time_high;
+    std::vector<uint64_t> last_change;
+
+    bool     active;
+    uint64_t start_tick;
+    uint64_t stop_tick;
+
+    size_t   instance_index(const std::vector<std::string>& path);
+    void     add_var(size_t inst, const char* name, const void* datap, int lsb,
+                     uint32_t width, uint32_t bytes, uint32_t entries, int index_base);
+    uint32_t load_word(const Net& n, uint32_t w) const;
+    void     write_instance(std::ostream& os, size_t inst, int indent,
+                            uint64_t duration, uint64_t period) const;
+};
+
+#endif // SAIF_H
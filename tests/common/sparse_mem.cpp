@@ -0,0 +1,148 @@
+/**
+ * @file sparse_mem.cpp
+ * @brief Sparse paged memory model used by `RAM.sv` when `USE_DPI_RAM` is
+ *        defined. The DPI-C entry points are in sparse_mem_dpi.cpp. See sparse_mem.h.
+ */
+
+#include "sparse_mem.h"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+
+SparseMem::SparseMem() : n_dirs(0), n_pages(0) {}
+
+
+SparseMem::Page* SparseMem::page(uint32_t addr, bool alloc) {
+    uint32_t root = addr >> (PAGE_BITS + DIR_BITS);
+    uint32_t leaf = (addr >> PAGE_BITS) & (DIR_SIZE - 1);
+
+    if (!dir[root]) {
+        if (!alloc) return nullptr;
+        dir[root].reset(new std::unique_ptr<Page>[DIR_SIZE]);
+        n_dirs++;
+    }
+    std::unique_ptr<Page>& p = dir[root][leaf];
+    if (!p) {
+        if (!alloc) return nullptr;
+        p.reset(new Page());    // Value-initialised: data and counters start at zero
+        n_pages++;
+    }
+    return p.get();
+}
+
+
+const SparseMem::Page* SparseMem::find(uint32_t addr) const {
+    uint32_t root = addr >> (PAGE_BITS + DIR_BITS);
+    uint32_t leaf = (addr >> PAGE_BITS) & (DIR_SIZE - 1);
+    if (!dir[root]) return nullptr;
+    return dir[root][leaf].get();
+}
+
+
+uint32_t SparseMem::read_word(uint32_t addr) {
+    addr &= ~3u;
+    // Reading an untouched page returns zero without allocating it
+    Page* p = page(addr, false);
+    if (!p) return 0;
+
+    uint32_t data;
+    std::memcpy(&data, &p->data[addr & (PAGE_SIZE - 1)], 4);
+    p->reads++;
+    return data;
+}
+
+
+void SparseMem::write_word(uint32_t addr, uint32_t data, uint8_t byte_en) {
+    addr &= ~3u;
+    if ((byte_en & 0xF) == 0) return;
+
+    Page* p = page(addr, true);
+    uint8_t* dst = &p->data[addr & (PAGE_SIZE - 1)];
+    for (int i = 0; i < 4; i++) {
+        if (byte_en & (1 << i)) dst[i] = (data >> (8 * i)) & 0xFF;
+    }
+    p->writes++;
+}
+
+
+void SparseMem::load(uint32_t addr, const void* src, size_t len) {
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+    while (len) {
+        uint32_t off = addr & (PAGE_SIZE - 1);
+        size_t chunk = PAGE_SIZE - off;
+        if (chunk > len) chunk = len;
+        std::memcpy(&page(addr, true)->data[off], s, chunk);
+        addr += chunk;
+        s += chunk;
+        len -= chunk;
+    }
+}
+
+
+void SparseMem::dump(uint32_t addr, void* dst, size_t len) const {
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    while (len) {
+        uint32_t off = addr & (PAGE_SIZE - 1);
+        size_t chunk = PAGE_SIZE - off;
+        if (chunk > len) chunk = len;
+        const Page* p = find(addr);
+        if (p) std::memcpy(d, &p->data[off], chunk);
+        else   std::memset(d, 0, chunk);
+        addr += chunk;
+        d += chunk;
+        len -= chunk;
+    }
+}
+
+
+bool SparseMem::load_file(uint32_t addr, const char* path) {
+    std::ifstream infile(path, std::ios::binary);
+    if (!infile) return false;
+
+    // Read the file page by page straight into the page storage
+    while (infile.peek() != std::char_traits<char>::eof()) {
+        uint32_t off = addr & (PAGE_SIZE - 1);
+        Page* p = page(addr, true);
+        infile.read(reinterpret_cast<char*>(&p->data[off]), PAGE_SIZE - off);
+        addr += infile.gcount();
+    }
+    return true;
+}
+
+
+void SparseMem::for_each_page(const std::function<void(uint32_t base, const Page&)>& fn) const {
+    for (uint32_t root = 0; root < ROOT_SIZE; root++) {
+        if (!dir[root]) continue;
+        for (uint32_t leaf = 0; leaf < DIR_SIZE; leaf++) {
+            if (dir[root][leaf]) {
+                fn((root << (PAGE_BITS + DIR_BITS)) | (leaf << PAGE_BITS), *dir[root][leaf]);
+            }
+        }
+    }
+}
+
+
+void SparseMem::report(std::ostream& os) const {
+    os << "Sparse memory: " << n_pages << " pages allocated ("
+       << footprint_bytes() / 1024 << " KB)" << std::endl;
+
+    for_each_page([&os](uint32_t base, const Page& p) {
+        os << "  Page 0x" << std::hex << std::setw(8) << std::setfill('0') << base << std::dec
+           << "\t reads: " << p.reads
+           << "\t writes: " << p.writes << std::endl;
+    });
+}
+
+
+void SparseMem::clear() {
+    for (uint32_t root = 0; root < ROOT_SIZE; root++) dir[root].reset();
+    n_dirs = 0;
+    n_pages = 0;
+}
+
+
+SparseMem& sparse_mem() {
+    static SparseMem default_mem;
+    return default_mem;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file sparse_mem.h
+ * @brief Sparse paged memory model backing `RAM.sv` through DPI-C.
+ *
+ * When the RTL is built with `USE_DPI_RAM` the RAM module does not hold a
+ * register array; every read and write is forwarded to this model. Memory is
+ * kept in 4 KB pages that are allocated the first time they are touched, so a
+ * 1 MB (or larger) RAM costs only the pages the firmware really uses.
+ *
+ * The harness can load and dump memory directly into/out of the pages
+ * (no intermediate array in the Verilated model) and read per-page access
+ * counters at the end of a run.
+ *
+ * A model accesses the memory bound to its VerilatedContext with
+ * `sparse_mem_bind()`. The binding follows the RAM instances, not the calling
+ * thread, so it holds on the worker threads of a multi-threaded model. Models
+ * with nothing bound use a process-wide default instance.
+ */
+
+#ifndef SPARSE_MEM_H
+#define SPARSE_MEM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <functional>
+
+class SparseMem {
+public:
+    static constexpr uint32_t PAGE_BITS  = 12;                  // 4 KB pages
+    static constexpr uint32_t PAGE_SIZE  = 1u << PAGE_BITS;
+    static constexpr uint32_t DIR_BITS   = 10;                  // Second level: 1024 pages per directory
+    static constexpr uint32_t DIR_SIZE   = 1u << DIR_BITS;
+    static constexpr uint32_t ROOT_SIZE  = 1u << (32 - PAGE_BITS - DIR_BITS);
+
+    struct Page {
+        uint8_t  data[PAGE_SIZE];
+        uint64_t reads;
+        uint64_t writes;
+    };
+
+    SparseMem();
+
+    SparseMem(const SparseMem&) = delete;
+    SparseMem& operator=(const SparseMem&) = delete;
+
+    // Word access used by the DPI functions. Addresses are byte addresses,
+    // the lower two bits are ignored.
+    uint32_t read_word(uint32_t addr);
+    void     write_word(uint32_t addr, uint32_t data, uint8_t byte_en);
+
+    // Returns the page holding addr. With alloc=false, untouched pages return nullptr.
+    Page*    page(uint32_t addr, bool alloc);
+
+    // Bulk load/dump. Data is copied straight into/out of the pages.
+    void     load(uint32_t addr, const void* src, size_t len);
+    void     dump(uint32_t addr, void* dst, size_t len) const;
+    bool     load_file(uint32_t addr, const char* path);   // Raw little-endian binary
+
+    // Visit every allocated page in address order without copying it.
+    void     for_each_page(const std::function<void(uint32_t base, const Page&)>& fn) const;
+
+    size_t   pages_allocated() const { return n_pages; }
+    // Host memory used: the first-level directory, the second-level directories and the pages
+    size_t   footprint_bytes() const {
+        return sizeof(dir) + n_dirs * DIR_SIZE * sizeof(std::unique_ptr<Page>) + n_pages * sizeof(Page);
+    }
+    void     report(std::ostream& os) const;
+    void     clear();
+
+private:
+    std::unique_ptr<std::unique_ptr<Page>[]> dir[ROOT_SIZE];
+    size_t n_dirs;
+    size_t n_pages;
+
+    const Page* find(uint32_t addr) const;
+};
+
+class VerilatedContext;
+
+// Default instance, used by the models that have no memory bound
+SparseMem&  sparse_mem();
+
+// Select the memory seen by the RAM instances of the model(s) in contextp
+// (sparse_mem_dpi.cpp, needs the Verilator runtime). Passing nullptr restores
+// the default instance; unbind before the model is deleted.
+void        sparse_mem_bind(VerilatedContext* contextp, SparseMem* mem);
+
+#endif // SPARSE_MEM_H
@@ -0,0 +1,46 @@
+/**
+ * @file sparse_mem_dpi.cpp
+ * @brief DPI-C entry points of the sparse memory model and the per-model
+ *        binding. Linked with the Verilated model when `USE_DPI_RAM` is defined.
+ *        See sparse_mem.h.
+ */
+
+#include "sparse_mem.h"
+#include "verilated.h"
+#include "verilated_syms.h"
+#include "svdpi.h"
+
+
+// svPutUserData/svGetUserData key: the address is unique, the value unused
+static int user_key;
+
+
+// The pointer is stored on every scope of the context, so it reaches both RAM
+// instances (ram and ext_ram) without naming them and whatever the top module.
+// One model per context: the models of a shared context see the same memory.
+void sparse_mem_bind(VerilatedContext* contextp, SparseMem* mem) {
+    for (const auto& it : *contextp->scopeNameMap()) {
+        svPutUserData(reinterpret_cast<svScope>(const_cast<VerilatedScope*>(it.second)), &user_key, mem);
+    }
+}
+
+
+// Memory of the RAM instance making the call (the imports are context imports,
+// so svGetScope() is the caller on any model thread)
+static SparseMem& scope_mem() {
+    void* mem = svGetUserData(svGetScope(), &user_key);
+    return mem ? *static_cast<SparseMem*>(mem) : sparse_mem();
+}
+
+
+// Prototypes must match the imports in RAM.sv:
+//   import "DPI-C" context function int  dpi_mem_read(input int addr);
+//   import "DPI-C" context function void dpi_mem_write(input int addr, input int data, input byte byte_en);
+extern "C" int dpi_mem_read(int addr) {
+    return static_cast<int>(scope_mem().read_word(static_cast<uint32_t>(addr)));
+}
+
+extern "C" void dpi_mem_write(int addr, int data, char byte_en) {
+    scope_mem().write_word(static_cast<uint32_t>(addr), static_cast<uint32_t>(data),
+                           static_cast<uint8_t>(byte_en));
+}
@@ -0,0 +1,74 @@
+/**
+ * @file uart_boot.cpp
+ * @brief Host-side uploader for the UART boot mode. See uart_boot.h.
+ */
+
+#include "uart_boot.h"
+#include <fstream>
+
+namespace uart_boot {
+
+uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    }
+    return ~crc;
+}
+
+static void put_le32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+std::vector<uint8_t> build_frame(uint32_t load_addr, const std::vector<uint32_t>& words) {
+    std::vector<uint8_t> frame;
+    frame.push_back(SYNC);
+    put_le32(frame, load_addr);
+    put_le32(frame, static_cast<uint32_t>(words.size()));
+    for (uint32_t w : words) put_le32(frame, w);
+
+    // The CRC covers everything after the SYNC byte
+    put_le32(frame, crc32(frame.data() + 1, frame.size() - 1));
+    return frame;
+}
+
+std::vector<uint32_t> read_image(const std::string& path) {
+    std::vector<uint32_t> words;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '/') continue;
+        words.push_back(static_cast<uint32_t>(std::stoul(line, nullptr, 2)));
+    }
+    return words;
+}
+
+} // namespace uart_boot
+
+
+UartBootUploader::UartBootUploader(DriveFn drive, TickFn tick, uint32_t bit_cycles)
+    : drive(std::move(drive)), tick(std::move(tick)), bit_cycles(bit_cycles) {}
+
+void UartBootUploader::hold(bool level, uint32_t bits) {
+    drive(level);
+    for (uint64_t i = 0; i < static_cast<uint64_t>(bits) * bit_cycles; i++) {
+        tick();
+        n_cycles++;
+    }
+}
+
+void UartBootUploader::send_byte(uint8_t byte, uint32_t idle_bits) {
+    hold(false, 1);                                     // Start bit
+    for (int i = 0; i < 8; i++) hold((byte >> i) & 1, 1);
+    hold(true, 1 + idle_bits);                          // Stop bit
+}
+
+void UartBootUploader::send(const std::vector<uint8_t>& bytes) {
+    hold(true, 2);                                      // Line idle before the first start bit
+    for (uint8_t b : bytes) send_byte(b);
+}
+
+void UartBootUploader::upload(uint32_t load_addr, const std::vector<uint32_t>& words) {
+    send(uart_boot::build_frame(load_addr, words));
+}
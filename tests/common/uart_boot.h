@@ -0,0 +1,67 @@
+/**
+ * @file uart_boot.h
+ * @brief Host-side uploader for the UART boot mode of `Programming_controller`.
+ *
+ * Builds the boot frame (SYNC 0x55, load address, word count, data, CRC-32,
+ * multi-byte fields little-endian) and bit-bangs it on the RX pin of the
+ * model at any bit period; the loader measures the period on the SYNC byte.
+ * The uploader only needs two callbacks, so it works with any harness:
+ *
+ *     UartBootUploader up([&](bool b) { top->uart_rx = b; },
+ *                         [&]() { clk_tick(top); }, 16);
+ *     top->uart_boot = 1;             // strap, before releasing the reset
+ *     up.upload(0, uart_boot::read_image("program.bin"));
+ *
+ * After the last CRC byte the controller resets the CPU into the new image.
+ */
+
+#ifndef UART_BOOT_H
+#define UART_BOOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace uart_boot {
+
+constexpr uint8_t SYNC = 0x55;
+
+// CRC-32 (IEEE 802.3, same as zlib crc32). Pass the previous result to continue.
+uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+// Complete frame, starting with the SYNC byte
+std::vector<uint8_t> build_frame(uint32_t load_addr, const std::vector<uint32_t>& words);
+
+// Words of a `$readmemb` image (as written by gcc-toolchain/binary_converter.py)
+std::vector<uint32_t> read_image(const std::string& path);
+
+} // namespace uart_boot
+
+
+class UartBootUploader {
+public:
+    using DriveFn = std::function<void(bool)>;     // Set the RX pin
+    using TickFn  = std::function<void()>;         // Advance one clock cycle
+
+    UartBootUploader(DriveFn drive, TickFn tick, uint32_t bit_cycles);
+
+    // One 8N1 byte, then idle_bits of stop level
+    void send_byte(uint8_t byte, uint32_t idle_bits = 0);
+    void send(const std::vector<uint8_t>& bytes);
+    void upload(uint32_t load_addr, const std::vector<uint32_t>& words);
+
+    void     set_bit_cycles(uint32_t cycles) { bit_cycles = cycles; }
+    uint64_t cycles() const { return n_cycles; }   // Clock cycles driven so far
+
+private:
+    DriveFn  drive;
+    TickFn   tick;
+    uint32_t bit_cycles;
+    uint64_t n_cycles = 0;
+
+    void hold(bool level, uint32_t bits);
+};
+
+#endif // UART_BOOT_H
@@ -2,7 +2,9 @@
  * @file EXT_PER_tb.cpp
  * @brief Verilator testbench for EXT_WRAPPER peripheral.
  * 
- * Tests the external peripheral by observing GPIO outputs.
+ * Tests the external peripheral by observing GPIO outputs. The program runs
+ * until it returns from main (tests/common/host_exit.h), then the GPIO value
+ * and the exit code are printed.
  * Generates `waveform.vcd` when tracing is enabled.
  * 
  * Author: ridoluc
@@ -14,11 +16,15 @@
 #include "verilated.h"
 #include <verilated_vcd_c.h> // Add this line
 #include "VEXT_WRAPPER___024root.h"
+#define HOST_SOC(sig) EXT_WRAPPER__DOT__top__DOT__##sig    // SYSTEM_TOP instance in EXT_WRAPPER.sv
+#include "../common/host_exit.h"
 #include <iostream>
 #include <iomanip> 
 #include <vector>
 #include <cassert>
 
+#define MAX_CYCLES 5000
+
 vluint64_t main_time = 0;
 
 VerilatedVcdC* tfp = nullptr; 
@@ -44,9 +50,11 @@ int main(int argc, char** argv) {
     Verilated::traceEverOn(true); // Enable tracing
     VEXT_WRAPPER* top = new VEXT_WRAPPER;
 
+#if VM_TRACE
     tfp = new VerilatedVcdC; // Create trace object
     top->trace(tfp, 99);     // Trace 99 levels of hierarchy
     tfp->open("waveform.vcd"); // Open VCD file
+#endif
 
     /////////  Reset the system  /////////
     std::cout << "Resetting the system..." << std::endl;
@@ -55,20 +63,21 @@ int main(int argc, char** argv) {
     top->rst_n = 1; // Deassert reset
     clk_tick(top); // Clock tick to complete reset
 
-    int counter = 0;
-    int gpio_out_prev = top->gpio_out; // Initialize previous GPIO output state
-    int start_time = main_time;
-
-
-    while (++counter < 256){
-        clk_tick(top);
-    };
+    uint64_t cycles = host_run(top, [&]() { clk_tick(top); }, MAX_CYCLES);
+    bool finished = host_finished(top);
+    if (!finished) {
+        std::cout << "EXT peripheral test: no exit after " << MAX_CYCLES << " cycles" << std::endl;
+    }
 
     std::cout << "T: " << (int)main_time << " GPIO Out: " << std::bitset<8>(top->gpio_out) << " (" << (int)top->gpio_out << ")" << std::endl;
+    std::cout << "Exit code " << host_exit_code(top) << " after " << cycles << " cycles" << std::endl;
 
 
-    tfp->close(); // Close VCD file
-    delete tfp;
+    if (tfp) {
+        tfp->close(); // Close VCD file
+        delete tfp;
+    }
+    top->final();
     delete top;
-    return 0;
+    return finished ? 0 : 1;
 }
@@ -46,6 +46,7 @@ module EXT_WRAPPER (
 
         .uart_tx(),
         .uart_rx(),
+        .uart_boot(1'b0),
 
         .tck(),
         .tms(),
@@ -0,0 +1,234 @@
+/**
+ * @file Random_tb.cpp
+ * @brief Constrained-random RV32IM test for `SYSTEM_TOP` (Verilator).
+ *
+ * Every seed gives a random program (rv32im_gen.h) that is run on the RTL and
+ * on the reference model (rv32im_iss.h). At the end the registers x1..x31 and
+ * the 256-byte DMEM window must match. Seeds are spread over worker threads;
+ * each thread owns one model and reuses it: the program and the initial DMEM
+ * are backdoor loaded through the public signals, then the CPU is reset.
+ *
+ *     ./Random_tb +seeds=10000 +threads=8       seeds 0..9999 on 8 threads
+ *     ./Random_tb +seed=1234                    one seed, e.g. to debug a failure
+ *     ./Random_tb +seed=1000 +seeds=500         seeds 1000..1499
+ *     ./Random_tb +length=200                   body length in instructions
+ *
+ * The first difference of each failing seed is printed and the program is
+ * written to `fail_<seed>.bin` ($readmemb format), so it can be copied to
+ * `instr_mem.bin` of another test or run by Bench_tb. The runner reports the
+ * number of seeds per second and returns 1 on any failure.
+ *
+ * With `USE_DPI_RAM` (Makefile `DPI_RAM=1`) each model has its own context
+ * and sparse memory bound to it, so the models do not share the data memory,
+ * also when they are Verilated with threads (`MODEL_THREADS=2`, the
+ * Random_dpi_tb CMake test).
+ */
+
+#include "VSYSTEM_TOP.h"
+#include "verilated.h"
+#include "VSYSTEM_TOP___024root.h"
+#include "../common/host_exit.h"
+#include "rv32im_gen.h"
+#include "rv32im_iss.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef USE_DPI_RAM
+#include "../common/sparse_mem.h"
+#endif
+
+#define MAX_CYCLES      50000
+#define ISS_MAX_STEPS   10000
+#define RAM_DMEM_INDEX  (rv32im::DMEM_BASE / 4)     // ram_registers index of DMEM_BASE
+
+using namespace rv32im;
+
+std::mutex report_mutex;    // Serializes the failure reports
+
+
+// One model per thread, reused for every seed of that thread
+class Harness {
+public:
+    Harness() : contextp(new VerilatedContext), top(new VSYSTEM_TOP(contextp.get())) {
+#ifdef USE_DPI_RAM
+        sparse_mem_bind(contextp.get(), &mem);     // The model's own memory, not the shared default
+#endif
+        top->eval(); // Run the initial blocks ($readmemb) before the backdoor loads
+    }
+
+    ~Harness() {
+        top->final();
+#ifdef USE_DPI_RAM
+        sparse_mem_bind(contextp.get(), nullptr);
+#endif
+    }
+
+    // Returns an empty string when the RTL matches the reference model
+    std::string run(const Program& prog);
+
+private:
+    std::unique_ptr<VerilatedContext> contextp;
+    std::unique_ptr<VSYSTEM_TOP> top;
+#ifdef USE_DPI_RAM
+    SparseMem mem;
+#endif
+
+    void clk_tick() {
+        top->clk = 1;
+        top->eval();
+        top->clk = 0;
+        top->eval();
+    }
+
+    void load(const Program& prog);
+    uint32_t dmem_word(uint32_t i);
+};
+
+
+void Harness::load(const Program& prog) {
+    auto* root = top->rootp;
+    for (size_t i = 0; i < IMEM_WORDS; i++) {
+        root->SYSTEM_TOP__DOT__instruction_memory__DOT__instruction_memory[i] =
+            i < prog.imem.size() ? prog.imem[i] : 0;
+    }
+#ifdef USE_DPI_RAM
+    mem.clear();
+    mem.load(DMEM_BASE, prog.dmem.data(), DMEM_BYTES);
+#else
+    for (uint32_t i = 0; i < DMEM_WORDS; i++) {
+        root->SYSTEM_TOP__DOT__ram__DOT__ram_registers[RAM_DMEM_INDEX + i] = prog.dmem[i];
+    }
+#endif
+}
+
+
+uint32_t Harness::dmem_word(uint32_t i) {
+#ifdef USE_DPI_RAM
+    return mem.read_word(DMEM_BASE + 4 * i);
+#else
+    return top->rootp->SYSTEM_TOP__DOT__ram__DOT__ram_registers[RAM_DMEM_INDEX + i];
+#endif
+}
+
+
+std::string Harness::run(const Program& prog) {
+    std::ostringstream err;
+
+    Iss iss(prog);
+    if (!iss.run(ISS_MAX_STEPS)) {
+        err << "reference model: " << iss.error << " at PC 0x" << std::hex << iss.pc;
+        return err.str();
+    }
+
+    load(prog);
+    top->rst_n = 0;
+    top->clk = 0;
+    clk_tick();
+    clk_tick();
+    top->rst_n = 1;
+
+    // Same end condition as Bench_tb (host_exit.h): the self-jump reaches the decode stage unstalled
+    uint64_t retired = 0;
+    host_run(top.get(), [&]() {
+        if (!top->rootp->SYSTEM_TOP__DOT__cpu__DOT__stall &&
+            top->rootp->SYSTEM_TOP__DOT__cpu__DOT__instruction != 0) {
+            retired++;
+        }
+        clk_tick();
+    }, MAX_CYCLES);
+
+    if (!host_finished(top.get())) {
+        err << "timeout after " << MAX_CYCLES << " cycles";
+        return err.str();
+    }
+
+    for (int r = 1; r < 32; r++) {
+        uint32_t rtl = top->rootp->SYSTEM_TOP__DOT__cpu__DOT__registers__DOT__registers[r];
+        if (rtl != iss.x[r]) {
+            err << "x" << r << std::hex << ": RTL 0x" << rtl << ", expected 0x" << iss.x[r];
+            return err.str();
+        }
+    }
+    for (uint32_t i = 0; i < DMEM_WORDS; i++) {
+        uint32_t rtl = dmem_word(i);
+        if (rtl != iss.dmem[i]) {
+            err << std::hex << "DMEM 0x" << DMEM_BASE + 4 * i
+                << ": RTL 0x" << rtl << ", expected 0x" << iss.dmem[i];
+            return err.str();
+        }
+    }
+    if (retired != iss.instret) {
+        err << "retired " << retired << " instructions, expected " << iss.instret;
+        return err.str();
+    }
+    return "";
+}
+
+
+void write_program(const Program& prog) {
+    std::ofstream out("fail_" + std::to_string(prog.seed) + ".bin");
+    for (uint32_t w : prog.imem) {
+        for (int b = 31; b >= 0; b--) out << ((w >> b) & 1);
+        out << "\n";
+    }
+}
+
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+
+    uint64_t first_seed = 0;
+    uint64_t n_seeds = 1000;
+    unsigned n_threads = std::thread::hardware_concurrency();
+    size_t length = 160;
+
+    const char* arg;
+    if (*(arg = Verilated::commandArgsPlusMatch("seed="))) {
+        first_seed = std::strtoull(arg + 6, nullptr, 0);
+        n_seeds = 1;
+    }
+    if (*(arg = Verilated::commandArgsPlusMatch("seeds="))) n_seeds = std::strtoull(arg + 7, nullptr, 0);
+    if (*(arg = Verilated::commandArgsPlusMatch("threads="))) n_threads = std::strtoul(arg + 9, nullptr, 0);
+    if (*(arg = Verilated::commandArgsPlusMatch("length="))) length = std::strtoul(arg + 8, nullptr, 0);
+    if (n_threads > n_seeds) n_threads = static_cast<unsigned>(n_seeds);
+    if (n_threads == 0) n_threads = 1;
+
+    std::atomic<uint64_t> next(0);
+    std::atomic<uint64_t> failures(0);
+
+    auto worker = [&]() {
+        Harness h;
+        for (uint64_t i = next++; i < n_seeds; i = next++) {
+            Program prog = generate(first_seed + i, length);
+            std::string err = h.run(prog);
+            if (err.empty()) continue;
+
+            failures++;
+            std::lock_guard<std::mutex> lock(report_mutex);
+            std::cout << "FAIL seed " << prog.seed << ": " << err << std::endl;
+            write_program(prog);
+        }
+    };
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < n_threads; t++) threads.emplace_back(worker);
+    for (std::thread& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << n_seeds << " seeds (" << first_seed << ".." << first_seed + n_seeds - 1 << "), "
+              << n_threads << " threads, " << failures << " failed, "
+              << (seconds > 0 ? n_seeds / seconds : 0.0) << " seeds/s" << std::endl;
+
+    return failures ? 1 : 0;
+}
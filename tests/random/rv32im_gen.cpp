@@ -0,0 +1,270 @@
+/**
+ * @file rv32im_gen.cpp
+ * @brief Constrained-random RV32IM program generator. See rv32im_gen.h.
+ */
+
+#include "rv32im_gen.h"
+#include <random>
+
+namespace rv32im {
+
+// Opcodes
+static const uint32_t OP_LUI    = 0x37;
+static const uint32_t OP_AUIPC  = 0x17;
+static const uint32_t OP_JAL    = 0x6F;
+static const uint32_t OP_JALR   = 0x67;
+static const uint32_t OP_BRANCH = 0x63;
+static const uint32_t OP_LOAD   = 0x03;
+static const uint32_t OP_STORE  = 0x23;
+static const uint32_t OP_IMM    = 0x13;
+static const uint32_t OP_REG    = 0x33;
+static const uint32_t OP_CUSTOM0 = 0x0B;    // MAC, PMAC16
+
+static uint32_t enc_r(uint32_t f7, uint32_t rs2, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t op) {
+    return (f7 << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | op;
+}
+
+static uint32_t enc_i(int32_t imm, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t op) {
+    return ((static_cast<uint32_t>(imm) & 0xFFF) << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | op;
+}
+
+static uint32_t enc_s(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3) {
+    uint32_t i = static_cast<uint32_t>(imm);
+    return (((i >> 5) & 0x7F) << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | ((i & 0x1F) << 7) | OP_STORE;
+}
+
+static uint32_t enc_b(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3) {
+    uint32_t i = static_cast<uint32_t>(imm);
+    return (((i >> 12) & 1) << 31) | (((i >> 5) & 0x3F) << 25) | (rs2 << 20) | (rs1 << 15) |
+           (f3 << 12) | (((i >> 1) & 0xF) << 8) | (((i >> 11) & 1) << 7) | OP_BRANCH;
+}
+
+static uint32_t enc_u(uint32_t imm20, uint32_t rd, uint32_t op) {
+    return ((imm20 & 0xFFFFF) << 12) | (rd << 7) | op;
+}
+
+static uint32_t enc_j(int32_t imm, uint32_t rd) {
+    uint32_t i = static_cast<uint32_t>(imm);
+    return (((i >> 20) & 1) << 31) | (((i >> 1) & 0x3FF) << 21) | (((i >> 11) & 1) << 20) |
+           (((i >> 12) & 0xFF) << 12) | (rd << 7) | OP_JAL;
+}
+
+
+// Values whose arithmetic, shifts and signed/unsigned comparisons hit the corner cases
+static const uint32_t EDGE_VALUES[] = {
+    0x00000000, 0x00000001, 0xFFFFFFFF, 0x80000000, 0x7FFFFFFF, 0x80000001,
+    0xFFFFFFFE, 0x00000002, 0x00008000, 0xFFFF8000, 0x00007FFF, 0x000000FF,
+    0x00000080, 0xFFFFFF80, 0x0000FFFF, 0xAAAAAAAA
+};
+static const size_t N_EDGE = sizeof(EDGE_VALUES) / sizeof(EDGE_VALUES[0]);
+
+static const int32_t EDGE_IMM[] = { 0, 1, -1, 2047, -2048, 31, 32, -32 };
+static const size_t N_EDGE_IMM = sizeof(EDGE_IMM) / sizeof(EDGE_IMM[0]);
+
+
+class Generator {
+public:
+    Generator(uint64_t seed) : rng(seed) {}
+
+    Program build(uint64_t seed, size_t body_length);
+
+private:
+    enum Fixup { FIX_NONE, FIX_BRANCH, FIX_JAL, FIX_JALR };
+
+    struct Slot {
+        uint32_t word;
+        Fixup    fix;
+        size_t   target;    // Target block
+    };
+
+    std::mt19937_64 rng;
+    std::vector<Slot> body;
+    std::vector<size_t> block_start;    // First slot of each block
+    uint32_t recent[4] = {0, 0, 0, 0};  // Last written registers
+
+    uint32_t rand_u(uint32_t n) { return static_cast<uint32_t>(rng() % n); }
+    bool     chance(uint32_t percent) { return rand_u(100) < percent; }
+
+    uint32_t edge_or_random() {
+        return chance(50) ? EDGE_VALUES[rand_u(N_EDGE)] : static_cast<uint32_t>(rng());
+    }
+
+    int32_t imm12() {
+        return chance(40) ? EDGE_IMM[rand_u(N_EDGE_IMM)] : static_cast<int32_t>(rand_u(4096)) - 2048;
+    }
+
+    uint32_t pick_rd() {
+        uint32_t rd = chance(5) ? 0 : 1 + rand_u(31);
+        if (rd == BASE_REG) rd = 0;
+        for (int i = 3; i > 0; i--) recent[i] = recent[i - 1];
+        recent[0] = rd;
+        return rd;
+    }
+
+    // Half of the sources read a register written by one of the last instructions
+    uint32_t pick_rs() {
+        return chance(50) ? recent[rand_u(4)] : rand_u(32);
+    }
+
+    void emit(uint32_t word, Fixup fix = FIX_NONE, size_t target = 0) {
+        body.push_back({word, fix, target});
+    }
+
+    size_t forward_target() {
+        return block_start.size() + rand_u(6);   // The block after this one or up to 5 later
+    }
+
+    void gen_block();
+};
+
+
+void Generator::gen_block() {
+    block_start.push_back(body.size());
+    uint32_t kind = rand_u(100);
+
+    if (kind < 28) {
+        // R-type: ADD SUB SLL SLT SLTU XOR SRL SRA OR AND
+        static const uint32_t ops[][2] = {
+            {0x00, 0}, {0x20, 0}, {0x00, 1}, {0x00, 2}, {0x00, 3},
+            {0x00, 4}, {0x00, 5}, {0x20, 5}, {0x00, 6}, {0x00, 7}
+        };
+        const uint32_t* op = ops[rand_u(10)];
+        uint32_t rs1 = pick_rs(), rs2 = pick_rs();
+        emit(enc_r(op[0], rs2, rs1, op[1], pick_rd(), OP_REG));
+
+    } else if (kind < 46) {
+        // I-type: ADDI SLTI SLTIU XORI ORI ANDI SLLI SRLI SRAI
+        uint32_t f3 = rand_u(8);
+        uint32_t rs1 = pick_rs();
+        if (f3 == 1 || f3 == 5) {
+            uint32_t shamt = chance(30) ? (chance(50) ? 0 : 31) : rand_u(32);
+            uint32_t f7 = (f3 == 5 && chance(50)) ? 0x20 : 0x00;
+            emit(enc_r(f7, shamt, rs1, f3, pick_rd(), OP_IMM));
+        } else {
+            emit(enc_i(imm12(), rs1, f3, pick_rd(), OP_IMM));
+        }
+
+    } else if (kind < 50) {
+        emit(enc_u(chance(30) ? 0x80000 : rand_u(1 << 20), pick_rd(), OP_LUI));
+
+    } else if (kind < 52) {
+        emit(enc_u(rand_u(1 << 20), pick_rd(), OP_AUIPC));
+
+    } else if (kind < 64) {
+        // M extension, 10% divide/multiply by x0
+        uint32_t rs1 = pick_rs();
+        uint32_t rs2 = chance(10) ? 0 : pick_rs();
+        if (chance(20)) {
+            // MAC / PMAC16, the accumulator rd is often a source too.
+            // 10% reserved funct3, which must not write rd.
+            uint32_t rd = chance(30) ? rs1 : pick_rd();
+            if (rd == BASE_REG) rd = 0;
+            uint32_t f3 = chance(10) ? 2 + rand_u(6) : rand_u(2);
+            emit(enc_r(0x00, rs2, rs1, f3, rd, OP_CUSTOM0));
+        } else {
+            emit(enc_r(0x01, rs2, rs1, rand_u(8), pick_rd(), OP_REG));
+        }
+
+    } else if (kind < 67) {
+        // Signed overflow: INT_MIN / -1 and INT_MIN % -1
+        uint32_t ra = pick_rd(), rb = pick_rd();
+        if (ra == 0 || rb == 0 || ra == rb) { emit(enc_i(0, 0, 0, 0, OP_IMM)); return; }
+        emit(enc_u(0x80000, ra, OP_LUI));
+        emit(enc_i(-1, 0, 0, rb, OP_IMM));
+        emit(enc_r(0x01, rb, ra, chance(50) ? 4 : 6, pick_rd(), OP_REG));
+
+    } else if (kind < 77) {
+        // Loads: LB LH LW LBU LHU, aligned offset from the DMEM base
+        static const uint32_t f3s[] = {0, 1, 2, 4, 5};
+        static const uint32_t sizes[] = {1, 2, 4, 1, 2};
+        uint32_t k = rand_u(5);
+        int32_t off = static_cast<int32_t>(rand_u(DMEM_BYTES / sizes[k]) * sizes[k]);
+        emit(enc_i(off, BASE_REG, f3s[k], pick_rd(), OP_LOAD));
+
+    } else if (kind < 85) {
+        // Stores: SB SH SW
+        uint32_t f3 = rand_u(3);
+        uint32_t size = 1u << f3;
+        int32_t off = static_cast<int32_t>(rand_u(DMEM_BYTES / size) * size);
+        emit(enc_s(off, pick_rs(), BASE_REG, f3));
+
+    } else if (kind < 94) {
+        // Branches, sometimes comparing against a freshly loaded edge value
+        static const uint32_t f3s[] = {0, 1, 4, 5, 6, 7};
+        uint32_t rs1 = pick_rs();
+        if (chance(40)) {
+            rs1 = pick_rd();
+            if (rs1 == 0) rs1 = 1;
+            uint32_t v = EDGE_VALUES[rand_u(N_EDGE)];
+            emit(enc_u((v + 0x800) >> 12, rs1, OP_LUI));
+            emit(enc_i(static_cast<int32_t>(v << 20) >> 20, rs1, 0, rs1, OP_IMM));
+        }
+        uint32_t rs2 = pick_rs();
+        emit(enc_b(0, rs2, rs1, f3s[rand_u(6)]), FIX_BRANCH, forward_target());
+
+    } else if (kind < 97) {
+        emit(enc_j(0, pick_rd()), FIX_JAL, forward_target());
+
+    } else {
+        // auipc + jalr pair, the target is relative to the auipc
+        uint32_t rx = 1 + rand_u(31);
+        if (rx == BASE_REG) rx = 1;
+        emit(enc_u(0, rx, OP_AUIPC));
+        emit(enc_i(0, rx, 0, pick_rd(), OP_JALR), FIX_JALR, forward_target());
+    }
+}
+
+
+Program Generator::build(uint64_t seed, size_t body_length) {
+    Program prog;
+    prog.seed = seed;
+    prog.dmem.resize(DMEM_WORDS);
+    for (uint32_t& w : prog.dmem) w = static_cast<uint32_t>(rng());
+
+    // Prologue: x3 = DMEM base, then every other register from DMEM
+    std::vector<uint32_t> prologue;
+    prologue.push_back(enc_i(DMEM_BASE, 0, 0, BASE_REG, OP_IMM));
+    uint32_t slot = 0;
+    for (uint32_t r = 1; r < 32; r++) {
+        if (r == BASE_REG) continue;
+        prog.dmem[slot] = edge_or_random();
+        prologue.push_back(enc_i(static_cast<int32_t>(4 * slot), BASE_REG, 2, r, OP_LOAD));
+        slot++;
+    }
+
+    size_t max_body = IMEM_WORDS - prologue.size() - 1;
+    if (body_length > max_body) body_length = max_body;
+    while (body.size() + 3 <= body_length) gen_block();
+
+    // Epilogue block: every forward target past the end lands on the self-jump
+    size_t end_block = block_start.size();
+    block_start.push_back(body.size());
+    body.push_back({SELF_JUMP, FIX_NONE, 0});
+
+    // Resolve the forward branches and jumps
+    for (size_t i = 0; i < body.size(); i++) {
+        Slot& s = body[i];
+        if (s.fix == FIX_NONE) continue;
+        size_t target = s.target < end_block ? s.target : end_block;
+        int32_t offset = static_cast<int32_t>(4 * (block_start[target] - i));
+
+        switch (s.fix) {
+            case FIX_BRANCH: s.word = (s.word & 0x01FFF07F) | (enc_b(offset, 0, 0, 0) & ~OP_BRANCH); break;
+            case FIX_JAL:    s.word = enc_j(offset, (s.word >> 7) & 0x1F); break;
+            case FIX_JALR:   s.word = (s.word & 0x000FFFFF) | (static_cast<uint32_t>(offset + 4) << 20); break;
+            default: break;
+        }
+    }
+
+    prog.imem = prologue;
+    for (const Slot& s : body) prog.imem.push_back(s.word);
+    return prog;
+}
+
+
+Program generate(uint64_t seed, size_t body_length) {
+    Generator gen(seed);
+    return gen.build(seed, body_length);
+}
+
+} // namespace rv32im
@@ -0,0 +1,50 @@
+/**
+ * @file rv32im_gen.h
+ * @brief Constrained-random RV32IM program generator.
+ *
+ * Builds a self-contained program for the layout in gcc-toolchain/linker.ld:
+ * code in the 1 KB instruction memory (executed from PC 0, the CPU reset
+ * vector) and data in the 256-byte DMEM window at 0x100. A program is
+ *
+ *   - a prologue loading x1..x31 (except x3) from DMEM, where the initial
+ *     image holds edge values (0, 1, -1, INT_MIN, INT_MAX, ...),
+ *   - a random body,
+ *   - the `j .` self-jump used by the testbenches to detect the end.
+ *
+ * x3 (gp) always holds the DMEM base, so every load/store hits DMEM with an
+ * aligned offset. All branches and jumps go forward, so every program ends.
+ * The body biases source registers towards the last written ones (RAW and
+ * load-use hazards), divides by zero and INT_MIN / -1, and compares values
+ * whose signed and unsigned order differ. A few multiplies are replaced by
+ * the custom-0 MAC/PMAC16 instructions (and some reserved custom-0 funct3
+ * values, which are no-ops).
+ */
+
+#ifndef RV32IM_GEN_H
+#define RV32IM_GEN_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace rv32im {
+
+constexpr uint32_t IMEM_WORDS  = 256;           // 1 KB, see linker.ld
+constexpr uint32_t DMEM_BASE   = 0x00000100;
+constexpr uint32_t DMEM_BYTES  = 0x100;
+constexpr uint32_t DMEM_WORDS  = DMEM_BYTES / 4;
+constexpr uint32_t SELF_JUMP   = 0x0000006F;    // jal x0, 0
+constexpr uint32_t BASE_REG    = 3;             // gp: DMEM base, never overwritten
+
+struct Program {
+    uint64_t seed;
+    std::vector<uint32_t> imem;     // Instruction words from PC 0, ends with SELF_JUMP
+    std::vector<uint32_t> dmem;     // Initial DMEM image (DMEM_WORDS)
+};
+
+// Body length in instructions. The total is clamped to IMEM_WORDS.
+Program generate(uint64_t seed, size_t body_length = 160);
+
+} // namespace rv32im
+
+#endif // RV32IM_GEN_H
@@ -0,0 +1,176 @@
+/**
+ * @file rv32im_iss.cpp
+ * @brief RV32IM reference model. See rv32im_iss.h.
+ */
+
+#include "rv32im_iss.h"
+#include <cstring>
+
+namespace rv32im {
+
+Iss::Iss(const Program& prog) : pc(0), instret(0), imem(prog.imem) {
+    std::memset(x, 0, sizeof(x));
+    std::memcpy(dmem, prog.dmem.data(), sizeof(dmem));
+}
+
+
+bool Iss::run(uint64_t max_steps) {
+    for (uint64_t i = 0; i < max_steps; i++) {
+        if (pc / 4 < imem.size() && imem[pc / 4] == SELF_JUMP) return true;
+        if (!step()) return false;
+    }
+    error = "step limit reached";
+    return false;
+}
+
+
+bool Iss::load(uint32_t addr, uint32_t size, bool sign, uint32_t& value) {
+    uint32_t off = addr - DMEM_BASE;
+    if (off >= DMEM_BYTES || (addr & (size - 1))) {
+        error = "load outside DMEM";
+        return false;
+    }
+    uint32_t word = dmem[off / 4] >> (8 * (off & 3));
+    uint32_t bits = 8 * size;
+    value = bits == 32 ? word : word & ((1u << bits) - 1);
+    if (sign && bits < 32 && (value >> (bits - 1))) value |= ~0u << bits;
+    return true;
+}
+
+
+bool Iss::store(uint32_t addr, uint32_t size, uint32_t value) {
+    uint32_t off = addr - DMEM_BASE;
+    if (off >= DMEM_BYTES || (addr & (size - 1))) {
+        error = "store outside DMEM";
+        return false;
+    }
+    uint32_t shift = 8 * (off & 3);
+    uint32_t mask = (size == 4 ? ~0u : ((1u << (8 * size)) - 1)) << shift;
+    uint32_t& w = dmem[off / 4];
+    w = (w & ~mask) | ((value << shift) & mask);
+    return true;
+}
+
+
+static int32_t s32(uint32_t v) { return static_cast<int32_t>(v); }
+
+
+bool Iss::step() {
+    if (pc / 4 >= imem.size() || (pc & 3)) {
+        error = "PC outside the program";
+        return false;
+    }
+    uint32_t in = imem[pc / 4];
+    uint32_t op = in & 0x7F;
+    uint32_t rd = (in >> 7) & 0x1F;
+    uint32_t f3 = (in >> 12) & 0x7;
+    uint32_t a = x[(in >> 15) & 0x1F];
+    uint32_t b = x[(in >> 20) & 0x1F];
+    uint32_t f7 = in >> 25;
+
+    int32_t imm_i = s32(in) >> 20;
+    int32_t imm_s = (s32(in) >> 25 << 5) | ((in >> 7) & 0x1F);
+    int32_t imm_b = (s32(in) >> 31 << 12) | (((in >> 7) & 1) << 11) | (((in >> 25) & 0x3F) << 5) | (((in >> 8) & 0xF) << 1);
+    int32_t imm_j = (s32(in) >> 31 << 20) | (in & 0xFF000) | (((in >> 20) & 1) << 11) | (((in >> 21) & 0x3FF) << 1);
+
+    uint32_t next = pc + 4;
+    uint32_t res = 0;
+    bool write = true;
+
+    switch (op) {
+        case 0x37: res = in & 0xFFFFF000; break;                         // LUI
+        case 0x17: res = pc + (in & 0xFFFFF000); break;                  // AUIPC
+        case 0x6F: res = pc + 4; next = pc + imm_j; break;               // JAL
+        case 0x67: res = pc + 4; next = (a + imm_i) & ~1u; break;        // JALR
+
+        case 0x63: {                                                     // Branches
+            bool taken;
+            switch (f3) {
+                case 0:  taken = a == b; break;
+                case 1:  taken = a != b; break;
+                case 4:  taken = s32(a) <  s32(b); break;
+                case 5:  taken = s32(a) >= s32(b); break;
+                case 6:  taken = a <  b; break;
+                case 7:  taken = a >= b; break;
+                default: error = "illegal branch"; return false;
+            }
+            if (taken) next = pc + imm_b;
+            write = false;
+            break;
+        }
+
+        case 0x03: {                                                     // Loads
+            static const uint32_t size[8] = {1, 2, 4, 0, 1, 2, 0, 0};
+            if (!size[f3]) { error = "illegal load"; return false; }
+            if (!load(a + imm_i, size[f3], f3 < 4, res)) return false;
+            break;
+        }
+
+        case 0x23:                                                       // Stores
+            if (f3 > 2) { error = "illegal store"; return false; }
+            if (!store(a + imm_s, 1u << f3, b)) return false;
+            write = false;
+            break;
+
+        case 0x13:                                                       // OP-IMM
+        case 0x33: {                                                     // OP
+            bool reg = op == 0x33;
+            uint32_t src = reg ? b : static_cast<uint32_t>(imm_i);
+            uint32_t sh = src & 0x1F;
+
+            if (reg && f7 == 0x01) {                                     // M extension
+                int64_t sa = s32(a), sb = s32(b);
+                uint64_t ua = a, ub = b;
+                switch (f3) {
+                    case 0: res = a * b; break;
+                    case 1: res = static_cast<uint32_t>((sa * sb) >> 32); break;
+                    case 2: res = static_cast<uint32_t>((sa * static_cast<int64_t>(ub)) >> 32); break;
+                    case 3: res = static_cast<uint32_t>((ua * ub) >> 32); break;
+                    case 4: res = b == 0 ? ~0u : (a == 0x80000000 && b == ~0u) ? a : static_cast<uint32_t>(s32(a) / s32(b)); break;
+                    case 5: res = b == 0 ? ~0u : a / b; break;
+                    case 6: res = b == 0 ? a : (a == 0x80000000 && b == ~0u) ? 0 : static_cast<uint32_t>(s32(a) % s32(b)); break;
+                    case 7: res = b == 0 ? a : a % b; break;
+                }
+                break;
+            }
+
+            bool alt = (f7 & 0x20) && (reg || f3 == 5);
+            switch (f3) {
+                case 0: res = alt ? a - src : a + src; break;
+                case 1: res = a << sh; break;
+                case 2: res = s32(a) < s32(src); break;
+                case 3: res = a < src; break;
+                case 4: res = a ^ src; break;
+                case 5: res = alt ? static_cast<uint32_t>(s32(a) >> sh) : a >> sh; break;
+                case 6: res = a | src; break;
+                case 7: res = a & src; break;
+            }
+            break;
+        }
+
+        case 0x0B: {                                                     // Custom-0: MAC, PMAC16
+            uint32_t acc = x[rd];
+            if (f3 == 0) {
+                res = acc + a * b;
+            } else if (f3 == 1) {
+                int32_t lo = static_cast<int16_t>(a) * static_cast<int16_t>(b);
+                int32_t hi = static_cast<int16_t>(a >> 16) * static_cast<int16_t>(b >> 16);
+                res = acc + static_cast<uint32_t>(lo) + static_cast<uint32_t>(hi);
+            } else {
+                write = false;                                           // Reserved: no-op
+            }
+            break;
+        }
+
+        default:
+            error = "illegal opcode";
+            return false;
+    }
+
+    if (write && rd != 0) x[rd] = res;
+    pc = next;
+    instret++;
+    return true;
+}
+
+} // namespace rv32im
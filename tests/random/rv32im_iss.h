@@ -0,0 +1,42 @@
+/**
+ * @file rv32im_iss.h
+ * @brief RV32IM reference model for the random instruction tests.
+ *
+ * Executes a generated program (rv32im_gen.h) with the same memory layout as
+ * SYSTEM_TOP: code from PC 0 and the DMEM window at DMEM_BASE. The run stops
+ * on the `j .` self-jump, like the testbench. The custom-0 MAC and PMAC16
+ * instructions of the ALU are executed too.
+ */
+
+#ifndef RV32IM_ISS_H
+#define RV32IM_ISS_H
+
+#include "rv32im_gen.h"
+#include <string>
+
+namespace rv32im {
+
+class Iss {
+public:
+    uint32_t x[32];
+    uint32_t pc;
+    uint32_t dmem[DMEM_WORDS];
+    uint64_t instret;
+    std::string error;          // Set when the program leaves the layout
+
+    explicit Iss(const Program& prog);
+
+    // Run until the self-jump. Returns false on error or after max_steps.
+    bool run(uint64_t max_steps);
+
+private:
+    const std::vector<uint32_t>& imem;
+
+    bool step();
+    bool load(uint32_t addr, uint32_t size, bool sign, uint32_t& value);
+    bool store(uint32_t addr, uint32_t size, uint32_t value);
+};
+
+} // namespace rv32im
+
+#endif // RV32IM_ISS_H
@@ -0,0 +1,195 @@
+/**
+ * @file sparse_mem_test.cpp
+ * @brief Unit test of the sparse DPI-C memory model (tests/common/sparse_mem).
+ *
+ * Plain C++, no Verilated model: word access with byte enables, bulk
+ * load/dump and load_file across page and directory boundaries, reads of
+ * untouched memory, the access counters, footprint_bytes(), clear() and the
+ * default instance.
+ *
+ *     make run      (or the sparse_mem_test CMake test)
+ */
+
+#include "../common/sparse_mem.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+static int errors = 0;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            std::cout << "FAIL: " << __FILE__ << ":" << __LINE__ << ": " #cond << std::endl; \
+            errors++;                                                           \
+        }                                                                       \
+    } while (0)
+
+static constexpr uint32_t PAGE = SparseMem::PAGE_SIZE;
+static constexpr uint32_t DIR_SPAN = SparseMem::PAGE_SIZE * SparseMem::DIR_SIZE;   // 4 MB per directory
+static constexpr size_t ROOT_BYTES = SparseMem::ROOT_SIZE * sizeof(std::unique_ptr<std::unique_ptr<SparseMem::Page>[]>);
+static constexpr size_t DIR_BYTES  = SparseMem::DIR_SIZE * sizeof(std::unique_ptr<SparseMem::Page>);
+
+// Byte pattern that differs at every offset of a page
+static std::vector<uint8_t> pattern(size_t len, uint8_t seed) {
+    std::vector<uint8_t> v(len);
+    for (size_t i = 0; i < len; i++) v[i] = static_cast<uint8_t>(seed + i * 7 + (i >> 8));
+    return v;
+}
+
+void test_words() {
+    SparseMem mem;
+    CHECK(mem.pages_allocated() == 0);
+    CHECK(mem.footprint_bytes() == ROOT_BYTES);
+
+    // Untouched memory reads zero and is not allocated
+    CHECK(mem.read_word(0x00000100) == 0);
+    CHECK(mem.read_word(0xFFFFFFFC) == 0);
+    CHECK(mem.pages_allocated() == 0);
+
+    mem.write_word(0x00000100, 0x11223344, 0xF);
+    CHECK(mem.read_word(0x00000100) == 0x11223344);
+    CHECK(mem.read_word(0x00000103) == 0x11223344);     // Lower address bits ignored
+
+    // Byte enables
+    mem.write_word(0x00000100, 0xAABBCCDD, 0x2);
+    CHECK(mem.read_word(0x00000100) == 0x1122CC44);
+    mem.write_word(0x00000100, 0xAABBCCDD, 0xC);
+    CHECK(mem.read_word(0x00000100) == 0xAABBCC44);
+    mem.write_word(0x00000100, 0x00000000, 0x0);        // No byte enabled: no write
+    CHECK(mem.read_word(0x00000100) == 0xAABBCC44);
+    CHECK(mem.pages_allocated() == 1);
+
+    // Last word of a page and first word of the next one
+    mem.write_word(PAGE - 4, 0xCAFEF00D, 0xF);
+    mem.write_word(PAGE, 0x600DF00D, 0xF);
+    CHECK(mem.read_word(PAGE - 4) == 0xCAFEF00D);
+    CHECK(mem.read_word(PAGE) == 0x600DF00D);
+    CHECK(mem.pages_allocated() == 2);
+
+    // Top of the address space
+    mem.write_word(0xFFFFFFFC, 0x89ABCDEF, 0xF);
+    CHECK(mem.read_word(0xFFFFFFFC) == 0x89ABCDEF);
+    CHECK(mem.pages_allocated() == 3);
+    CHECK(mem.footprint_bytes() == ROOT_BYTES + 2 * DIR_BYTES + 3 * sizeof(SparseMem::Page));
+
+    // Per-page counters, pages visited in address order
+    std::vector<uint32_t> bases;
+    mem.for_each_page([&](uint32_t base, const SparseMem::Page& p) {
+        bases.push_back(base);
+        if (base == 0) {
+            CHECK(p.writes == 4);       // The write with no byte enabled is not counted
+            CHECK(p.reads == 6);        // Nor the read before the page existed
+        }
+    });
+    CHECK((bases == std::vector<uint32_t>{ 0x00000000, PAGE, 0xFFFFF000 }));
+}
+
+void test_load_dump() {
+    SparseMem mem;
+
+    // Unaligned load across three pages and a directory boundary
+    uint32_t addr = DIR_SPAN - PAGE - 10;
+    std::vector<uint8_t> src = pattern(PAGE + 20, 0x31);
+    mem.load(addr, src.data(), src.size());
+    CHECK(mem.pages_allocated() == 3);
+    CHECK(mem.footprint_bytes() == ROOT_BYTES + 2 * DIR_BYTES + 3 * sizeof(SparseMem::Page));
+
+    std::vector<uint8_t> dst(src.size(), 0xEE);
+    mem.dump(addr, dst.data(), dst.size());
+    CHECK(dst == src);
+
+    // Words straddling the pages match the bytes loaded
+    uint32_t w = DIR_SPAN - 4;
+    size_t off = w - addr;
+    CHECK(mem.read_word(w) == (uint32_t)(src[off] | src[off + 1] << 8 | src[off + 2] << 16 | src[off + 3] << 24));
+
+    // Dump through untouched pages returns zeros around the data
+    std::vector<uint8_t> wide(3 * PAGE + src.size(), 0xEE);
+    mem.dump(addr - 2 * PAGE, wide.data(), wide.size());
+    CHECK(std::memcmp(&wide[2 * PAGE], src.data(), src.size()) == 0);
+    bool zeros = true;
+    for (size_t i = 0; i < 2 * PAGE; i++) zeros &= wide[i] == 0;
+    for (size_t i = 2 * PAGE + src.size(); i < wide.size(); i++) zeros &= wide[i] == 0;
+    CHECK(zeros);
+    CHECK(mem.pages_allocated() == 3);      // dump does not allocate
+
+    // A bulk load does not touch the access counters
+    mem.for_each_page([&](uint32_t, const SparseMem::Page& p) {
+        CHECK(p.writes == 0);
+    });
+
+    mem.clear();
+    CHECK(mem.pages_allocated() == 0);
+    CHECK(mem.footprint_bytes() == ROOT_BYTES);
+    CHECK(mem.read_word(DIR_SPAN - 4) == 0);
+    mem.dump(addr, dst.data(), dst.size());
+    CHECK(dst == std::vector<uint8_t>(src.size(), 0));
+
+    // Usable again after clear
+    mem.load(addr, src.data(), src.size());
+    mem.dump(addr, dst.data(), dst.size());
+    CHECK(dst == src);
+}
+
+void test_load_file() {
+    SparseMem mem;
+    const char* path = "sparse_mem_test.tmp";
+
+    CHECK(!mem.load_file(0, "sparse_mem_test.missing"));
+    CHECK(mem.pages_allocated() == 0);
+
+    // Unaligned file load across a page boundary
+    std::vector<uint8_t> src = pattern(PAGE + 10, 0x5C);
+    FILE* f = std::fopen(path, "wb");
+    CHECK(f != nullptr);
+    if (!f) return;
+    std::fwrite(src.data(), 1, src.size(), f);
+    std::fclose(f);
+
+    uint32_t addr = 0x10000000 + PAGE - 6;
+    CHECK(mem.load_file(addr, path));
+    CHECK(mem.pages_allocated() == 3);
+
+    std::vector<uint8_t> dst(src.size() + 8, 0xEE);
+    mem.dump(addr - 4, dst.data(), dst.size());
+    CHECK(std::memcmp(&dst[4], src.data(), src.size()) == 0);
+    CHECK(dst[0] == 0 && dst[3] == 0 && dst[src.size() + 4] == 0 && dst[src.size() + 7] == 0);
+
+    // A file of exactly one page at a page boundary allocates one page
+    SparseMem page_mem;
+    f = std::fopen(path, "wb");
+    std::fwrite(src.data(), 1, PAGE, f);
+    std::fclose(f);
+    CHECK(page_mem.load_file(0x20000000, path));
+    CHECK(page_mem.pages_allocated() == 1);
+    CHECK(page_mem.read_word(0x20000000 + PAGE - 4) ==
+          (uint32_t)(src[PAGE - 4] | src[PAGE - 3] << 8 | src[PAGE - 2] << 16 | src[PAGE - 1] << 24));
+
+    std::remove(path);
+}
+
+// The per-model binding (sparse_mem_dpi.cpp) needs a Verilated model and is
+// covered by the Random_dpi_tb test; here only the default instance.
+void test_default() {
+    SparseMem mem;
+    SparseMem& def = sparse_mem();
+
+    CHECK(&sparse_mem() == &def);
+    CHECK(&def != &mem);
+    def.write_word(0x100, 0x12345678, 0xF);
+    CHECK(sparse_mem().read_word(0x100) == 0x12345678);
+    CHECK(mem.pages_allocated() == 0);
+    def.clear();
+}
+
+int main() {
+    test_words();
+    test_load_dump();
+    test_load_file();
+    test_default();
+
+    std::cout << (errors ? "sparse_mem test FAILED" : "sparse_mem test passed") << std::endl;
+    return errors ? 1 : 0;
+}